@@ -30,6 +30,7 @@ pub struct Target {
     pub data_layout: String,
 }
 
+#[derive(Clone)]
 pub struct CodeGen {
     classes: ClassGraph,
     vtables: VTableMap,
@@ -127,6 +128,12 @@ impl ClassCodeGen {
         let vtable_name = mangle::mangle_vtable_name(class_name);
         let vtable_type = self.decls.add_vtable_type(class_name)?;
 
+        let metadata_name = if !class_file.is_interface() {
+            Some(self.gen_class_metadata(class_file)?)
+        } else {
+            None
+        };
+
         writeln!(
             self.out,
             "@{vtable} = constant {vtyp} {{",
@@ -139,6 +146,11 @@ impl ClassCodeGen {
                 "  i32 {}, ; <number of methods>",
                 vtable.method_count()
             )?;
+            writeln!(
+                self.out,
+                "  i8* bitcast ({{ i8*, i8*, i8* }}* @{} to i8*), ; <class metadata>",
+                metadata_name.unwrap()
+            )?;
         }
         for (key, target) in vtable.iter_methods() {
             if target.class_name != *class_name {
@@ -182,11 +194,54 @@ impl ClassCodeGen {
             }
             writeln!(self.out, " ; #{} interface {}", idx, name)?;
         }
-        writeln!(self.out, "}}")?;
+        // the metadata section lets the runtime map these pages
+        // shared across processes (see runtime/lib/metadata.h)
+        writeln!(self.out, "}}, section \"jrt_metadata\"")?;
 
         Ok(())
     }
 
+    // per-class metadata record next to the vtable (_ZTI alongside
+    // _ZTV): class name, superclass vtable, and a writable slot where
+    // the runtime caches the lazily created java.lang.Class instance;
+    // that slot keeps the record itself out of the read-only shared
+    // jrt_metadata section (only the name bytes go there)
+    fn gen_class_metadata(&mut self, class_file: &ClassFile) -> Fallible<String> {
+        let class_name = class_file.get_name();
+        let metadata_name = mangle::mangle_class_metadata_name(class_name);
+        writeln!(
+            self.out,
+            "@{meta}.name = private constant [{len} x i8] {bytes}, section \"jrt_metadata\"",
+            meta = metadata_name,
+            len = class_name.len() + 1,
+            bytes = GenStringConst(class_name)
+        )?;
+        let super_field = match class_file.get_super_class() {
+            Some(super_const) => {
+                let super_name = class_file
+                    .constant_pool
+                    .get_utf8(super_const.name_index)
+                    .unwrap();
+                let super_vtable_type = self.decls.add_vtable_type(super_name)?;
+                let super_vtable_const = self.decls.add_vtable_const(super_name)?;
+                format!(
+                    "i8* bitcast ({vtyp}* {vtbl} to i8*)",
+                    vtyp = super_vtable_type,
+                    vtbl = super_vtable_const
+                )
+            }
+            None => "i8* null".to_owned(),
+        };
+        writeln!(
+            self.out,
+            "@{meta} = global {{ i8*, i8*, i8* }} {{ i8* getelementptr ([{len} x i8], [{len} x i8]* @{meta}.name, i64 0, i64 0), {super_field}, i8* null }}",
+            meta = metadata_name,
+            len = class_name.len() + 1,
+            super_field = super_field
+        )?;
+        Ok(metadata_name)
+    }
+
     fn gen_prelude(&mut self, out: &mut String) -> Fallible<()> {
         let mut prelude_code_gen = PreludeCodeGen {
             out,
@@ -286,6 +286,7 @@ impl<'a> DeclGen<'a> {
         writeln!(self.out, "%{} = type {{", vtable_name)?;
         if !class_file.is_interface() {
             writeln!(self.out, "  i32, ; <number of methods>")?;
+            writeln!(self.out, "  i8*, ; <class metadata>")?;
         }
         for (idx, (key, _)) in vtable.iter_methods().enumerate() {
             writeln!(
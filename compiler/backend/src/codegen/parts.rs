@@ -1,3 +1,4 @@
+mod escape;
 mod expr;
 mod method;
 mod prelude;
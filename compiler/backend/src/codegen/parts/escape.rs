@@ -0,0 +1,87 @@
+use std::collections::BTreeMap;
+
+use classfile::ConstantPool;
+use strbuf::StrBuf;
+
+use frontend::blocks::BlockGraph;
+use frontend::translate::{BranchStub, Expr, InvokeExpr, InvokeTarget, Op};
+
+// Conservative intra-method escape analysis backing the
+// _Jrt_object_init_onstack ABI: an object allocated by Expr::New can
+// live in an alloca'd frame slot when its reference provably never
+// outlives the frame. A candidate escapes when it is
+//
+//  - passed to any call (receiver or argument), except as the
+//    receiver of java.lang.Object.<init>, which is known to be empty
+//  - stored into a field or an array slot, returned, or thrown
+//  - still live in a block's outgoing frame, i.e. it crosses a basic
+//    block boundary, where phi nodes could alias it to other variables
+//
+// Everything else (field access on the object, monitor operations,
+// reference comparisons) keeps the candidate eligible.
+pub fn stack_allocatable(blocks: &BlockGraph, consts: &ConstantPool) -> BTreeMap<u64, StrBuf> {
+    let mut candidates = BTreeMap::new();
+    for block in blocks.blocks() {
+        for stmt in block.statements.iter() {
+            if let (Some(var), Expr::New(class_name)) = (&stmt.assign, &stmt.expression) {
+                candidates.insert(var.1, class_name.clone());
+            }
+        }
+    }
+    if candidates.is_empty() {
+        return candidates;
+    }
+
+    for block in blocks.blocks() {
+        for stmt in block.statements.iter() {
+            match &stmt.expression {
+                Expr::PutField(_, _, value) => escape(&mut candidates, value),
+                Expr::ArrayStore(_, _, _, value) => escape(&mut candidates, value),
+                Expr::Invoke(invoke) => {
+                    match invoke.target {
+                        InvokeTarget::Virtual(ref receiver)
+                        | InvokeTarget::Interface(ref receiver) => {
+                            escape(&mut candidates, receiver)
+                        }
+                        InvokeTarget::Special(ref receiver) => {
+                            if !is_object_init(invoke, consts) {
+                                escape(&mut candidates, receiver)
+                            }
+                        }
+                        InvokeTarget::Static => {}
+                    }
+                    for arg in invoke.args.iter() {
+                        escape(&mut candidates, arg);
+                    }
+                }
+                _ => {}
+            }
+        }
+        match &block.branch_stub {
+            BranchStub::Return(Some(op)) => escape(&mut candidates, op),
+            BranchStub::Throw(op) => escape(&mut candidates, op),
+            _ => {}
+        }
+        for op in block.outgoing.stack.iter() {
+            escape(&mut candidates, op);
+        }
+        for (_, op) in block.outgoing.locals.iter() {
+            escape(&mut candidates, op);
+        }
+    }
+
+    candidates
+}
+
+fn escape(candidates: &mut BTreeMap<u64, StrBuf>, op: &Op) {
+    if let Op::Var(var) = op {
+        candidates.remove(&var.1);
+    }
+}
+
+fn is_object_init(invoke: &InvokeExpr, consts: &ConstantPool) -> bool {
+    let method_name = consts.get_utf8(invoke.method.name_index).unwrap();
+    let method_class = consts.get_class(invoke.method.class_index).unwrap();
+    let method_class_name = consts.get_utf8(method_class.name_index).unwrap();
+    &**method_name == "<init>" && &**method_class_name == "java/lang/Object"
+}
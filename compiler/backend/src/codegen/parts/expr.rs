@@ -1,6 +1,8 @@
+use std::collections::BTreeMap;
 use std::fmt::Write;
 use std::sync::Arc;
 
+use classfile::descriptors::{BaseType, FieldType, ParameterDescriptor};
 use classfile::{ClassFile, ConstantIndex, ConstantPool, FieldRef};
 use failure::Fallible;
 use strbuf::StrBuf;
@@ -27,6 +29,7 @@ pub struct ExprCodeGen<'a> {
     pub field_layouts: &'a FieldLayoutMap,
     pub var_id_gen: &'a mut TmpVarIdGen,
     pub target: &'a Arc<Target>,
+    pub stack_allocs: &'a BTreeMap<u64, StrBuf>,
 }
 
 impl<'a> ExprCodeGen<'a> {
@@ -43,6 +46,9 @@ impl<'a> ExprCodeGen<'a> {
             Expr::Compare(compare_expr) => self.gen_expr_compare(compare_expr, dest)?,
             Expr::New(class_name) => self.gen_expr_new(class_name, dest)?,
             Expr::ArrayNew(ctyp, count) => self.gen_expr_array_new(ctyp, count, dest)?,
+            Expr::ArrayNewMulti(ctyp, counts) => {
+                self.gen_expr_array_new_multi(ctyp, counts, dest)?
+            }
             Expr::ArrayLength(aref) => self.gen_expr_array_length(aref, dest)?,
             Expr::ArrayLoad(ctyp, aref, idx) => self.gen_expr_array_load(ctyp, aref, idx, dest)?,
             Expr::ArrayStore(ctyp, aref, idx, val) => {
@@ -60,6 +66,22 @@ impl<'a> ExprCodeGen<'a> {
         let vtable_const = self.decls.add_vtable_const(class_name)?;
 
         if let Dest::Assign(assign) = dest {
+            // escape-analyzed allocations initialize a frame slot set
+            // up in the entry block instead of going through the heap
+            if let DestAssign::Var(ref var) = assign {
+                if self.stack_allocs.contains_key(&var.1) {
+                    writeln!(
+                        self.out,
+                        "  {} = call %ref @_Jrt_object_init_onstack(i8* %sp{id}, i64 {size}, i8* bitcast ({vtyp}* {vtbl} to i8*))",
+                        assign,
+                        id = var.1,
+                        size = GenSizeOf(&object_type),
+                        vtyp = vtable_type,
+                        vtbl = vtable_const
+                    )?;
+                    return Ok(());
+                }
+            }
             writeln!(
                 self.out,
                 "  {} = call %ref @_Jrt_object_new(i64 {size}, i8* bitcast ({vtyp}* {vtbl} to i8*))",
@@ -82,10 +104,11 @@ impl<'a> ExprCodeGen<'a> {
         if let Dest::Assign(assign) = dest {
             writeln!(
                 self.out,
-                "  {} = call %ref @_Jrt_ldstr(i8* getelementptr ([{} x i8], [{} x i8]* @.str{}, i64 0, i64 0))",
+                "  {} = call %ref @_Jrt_ldstr_cached(i8* getelementptr ([{} x i8], [{} x i8]* @.str{}, i64 0, i64 0), i8** @.strc{})",
                 assign,
                 len + 1,
                 len + 1,
+                index.into_u16(),
                 index.into_u16()
             )?;
         }
@@ -102,6 +125,39 @@ impl<'a> ExprCodeGen<'a> {
         let method_class = consts.get_class(expr.method.class_index).unwrap();
         let method_class_name = consts.get_utf8(method_class.name_index).unwrap();
 
+        // java.util.Arrays bulk operations over primitive arrays are
+        // lowered to the runtime's vectorized intrinsics instead of
+        // compiling the library's per-element loops
+        if let InvokeTarget::Static = expr.target {
+            if &**method_class_name == "java/util/Arrays"
+                && self.gen_arrays_intrinsic(expr, &method_name, &dest)?
+            {
+                return Ok(());
+            }
+        }
+
+        // java.lang.String is final, so a virtual call resolves to
+        // the class itself and hot methods can be lowered to the
+        // runtime's SIMD-backed string intrinsics
+        if let InvokeTarget::Virtual(ref var) = expr.target {
+            if &**method_class_name == "java/lang/String"
+                && self.gen_string_intrinsic(expr, &method_name, var, &dest)?
+            {
+                return Ok(());
+            }
+        }
+
+        // java.lang.StringBuilder (also final) is implemented natively
+        // by the runtime; compiled code carries no real vtable for it,
+        // so its calls must resolve here rather than dispatch
+        if let InvokeTarget::Virtual(ref var) = expr.target {
+            if &**method_class_name == "java/lang/StringBuilder"
+                && self.gen_stringbuilder_intrinsic(expr, &method_name, var, &dest)?
+            {
+                return Ok(());
+            }
+        }
+
         let fptr = match expr.target {
             InvokeTarget::Virtual(ref var) => {
                 let vtable = self.vtables.get(method_class_name)?;
@@ -220,6 +276,267 @@ impl<'a> ExprCodeGen<'a> {
         Ok(())
     }
 
+    fn gen_arrays_intrinsic(
+        &mut self,
+        expr: &InvokeExpr,
+        method_name: &StrBuf,
+        dest: &Dest,
+    ) -> Fallible<bool> {
+        // component type of a primitive-array parameter, when Java's
+        // element semantics match a width-based intrinsic; float and
+        // double are excluded because their NaN handling differs from
+        // a bitwise compare
+        fn integral_component(param: &ParameterDescriptor) -> Option<&BaseType> {
+            let ParameterDescriptor::Field(field_type) = param;
+            if let FieldType::Array(array_type) = field_type {
+                if let FieldType::Base(ref base) = *array_type.component_type {
+                    return match base {
+                        BaseType::Float | BaseType::Double => None,
+                        _ => Some(base),
+                    };
+                }
+            }
+            None
+        }
+
+        // element width in the emitted layout, not the JVM's: this
+        // compiler stores char arrays as i8 (see Type::Char and
+        // _Jrt_array_new_1), so char fills are byte-wide
+        fn component_width(base: &BaseType) -> u32 {
+            match base {
+                BaseType::Boolean | BaseType::Byte | BaseType::Char => 1,
+                BaseType::Short => 2,
+                BaseType::Int | BaseType::Float => 4,
+                BaseType::Long | BaseType::Double => 8,
+            }
+        }
+
+        let params = &expr.method.descriptor.params;
+        match (&**method_name, params.len()) {
+            // fill(a, value) and fill(a, from, to, value)
+            ("fill", 2) | ("fill", 4) => {
+                let base = match integral_component(&params[0]) {
+                    Some(base) => base,
+                    None => return Ok(false),
+                };
+                let width = component_width(base);
+                let value_type = if width == 8 { "i64" } else { "i32" };
+                if params.len() == 4 {
+                    writeln!(
+                        self.out,
+                        "  call void @_Jrt_array_fill_{width}(%ref {array}, i32 {from}, i32 {to}, {vtyp} {value})",
+                        width = width,
+                        array = OpVal(&expr.args[0]),
+                        from = OpVal(&expr.args[1]),
+                        to = OpVal(&expr.args[2]),
+                        vtyp = value_type,
+                        value = OpVal(&expr.args[3])
+                    )?;
+                } else {
+                    let tmp_len = self.var_id_gen.gen();
+                    writeln!(
+                        self.out,
+                        "  %t{} = call i32 @_Jrt_array_length(%ref {})",
+                        tmp_len,
+                        OpVal(&expr.args[0])
+                    )?;
+                    writeln!(
+                        self.out,
+                        "  call void @_Jrt_array_fill_{width}(%ref {array}, i32 0, i32 %t{len}, {vtyp} {value})",
+                        width = width,
+                        array = OpVal(&expr.args[0]),
+                        len = tmp_len,
+                        vtyp = value_type,
+                        value = OpVal(&expr.args[1])
+                    )?;
+                }
+                Ok(true)
+            }
+            ("equals", 2) => {
+                if integral_component(&params[0]).is_none()
+                    || integral_component(&params[1]).is_none()
+                {
+                    return Ok(false);
+                }
+                if let Dest::Assign(assign) = dest {
+                    writeln!(
+                        self.out,
+                        "  {} = call i32 @_Jrt_array_equals(%ref {}, %ref {})",
+                        assign,
+                        OpVal(&expr.args[0]),
+                        OpVal(&expr.args[1])
+                    )?;
+                }
+                Ok(true)
+            }
+            ("hashCode", 1) => {
+                match integral_component(&params[0]) {
+                    // char[] and boolean[] hash differently from the
+                    // signed type of the same width, so they take the
+                    // regular compiled path
+                    Some(BaseType::Byte)
+                    | Some(BaseType::Short)
+                    | Some(BaseType::Int)
+                    | Some(BaseType::Long) => {}
+                    _ => return Ok(false),
+                }
+                if let Dest::Assign(assign) = dest {
+                    writeln!(
+                        self.out,
+                        "  {} = call i32 @_Jrt_array_hash(%ref {})",
+                        assign,
+                        OpVal(&expr.args[0])
+                    )?;
+                }
+                Ok(true)
+            }
+            _ => Ok(false),
+        }
+    }
+
+    // String.equals is deliberately not lowered: its parameter is a
+    // plain Object, and the runtime can't yet type-check a ref
+    // against java.lang.String before reading a string header
+    fn gen_string_intrinsic(
+        &mut self,
+        expr: &InvokeExpr,
+        method_name: &StrBuf,
+        receiver: &Op,
+        dest: &Dest,
+    ) -> Fallible<bool> {
+        fn is_string(param: &ParameterDescriptor) -> bool {
+            let ParameterDescriptor::Field(field_type) = param;
+            match field_type {
+                // parsed descriptors carry dotted class names
+                FieldType::Object(object_type) => object_type.class_name == "java.lang.String",
+                _ => false,
+            }
+        }
+        fn is_int(param: &ParameterDescriptor) -> bool {
+            let ParameterDescriptor::Field(field_type) = param;
+            match field_type {
+                FieldType::Base(BaseType::Int) => true,
+                _ => false,
+            }
+        }
+
+        let params = &expr.method.descriptor.params;
+        let call = match (&**method_name, params.len()) {
+            ("hashCode", 0) => {
+                format!("call i32 @_Jrt_string_hash(%ref {})", OpVal(receiver))
+            }
+            ("indexOf", 1) if is_string(&params[0]) => format!(
+                "call i32 @_Jrt_string_index_of(%ref {}, %ref {}, i32 0)",
+                OpVal(receiver),
+                OpVal(&expr.args[0])
+            ),
+            ("indexOf", 2) if is_string(&params[0]) && is_int(&params[1]) => format!(
+                "call i32 @_Jrt_string_index_of(%ref {}, %ref {}, i32 {})",
+                OpVal(receiver),
+                OpVal(&expr.args[0]),
+                OpVal(&expr.args[1])
+            ),
+            ("indexOf", 1) if is_int(&params[0]) => format!(
+                "call i32 @_Jrt_string_index_of_char(%ref {}, i32 {}, i32 0)",
+                OpVal(receiver),
+                OpVal(&expr.args[0])
+            ),
+            ("indexOf", 2) if is_int(&params[0]) && is_int(&params[1]) => format!(
+                "call i32 @_Jrt_string_index_of_char(%ref {}, i32 {}, i32 {})",
+                OpVal(receiver),
+                OpVal(&expr.args[0]),
+                OpVal(&expr.args[1])
+            ),
+            ("intern", 0) => {
+                format!("call %ref @_Jrt_string_intern(%ref {})", OpVal(receiver))
+            }
+            _ => return Ok(false),
+        };
+        if let Dest::Assign(assign) = dest {
+            writeln!(self.out, "  {} = {}", assign, call)?;
+        } else if &**method_name == "intern" {
+            // interning mutates the table, so the call survives even
+            // when its result is discarded
+            writeln!(self.out, "  {}", call)?;
+        }
+        Ok(true)
+    }
+
+    // append(Object) and append(boolean) fall through to the regular
+    // dispatch path, which raises a link error instead of corrupting
+    // the builder silently
+    fn gen_stringbuilder_intrinsic(
+        &mut self,
+        expr: &InvokeExpr,
+        method_name: &StrBuf,
+        receiver: &Op,
+        dest: &Dest,
+    ) -> Fallible<bool> {
+        fn base_param(param: &ParameterDescriptor) -> Option<&BaseType> {
+            let ParameterDescriptor::Field(field_type) = param;
+            match field_type {
+                FieldType::Base(base_type) => Some(base_type),
+                _ => None,
+            }
+        }
+        fn is_string(param: &ParameterDescriptor) -> bool {
+            let ParameterDescriptor::Field(field_type) = param;
+            match field_type {
+                // parsed descriptors carry dotted class names
+                FieldType::Object(object_type) => object_type.class_name == "java.lang.String",
+                _ => false,
+            }
+        }
+
+        let params = &expr.method.descriptor.params;
+        let call = match (&**method_name, params.len()) {
+            ("append", 1) if is_string(&params[0]) => format!(
+                "call %ref @_Jrt_stringbuilder_append_string(%ref {}, %ref {})",
+                OpVal(receiver),
+                OpVal(&expr.args[0])
+            ),
+            ("append", 1) if base_param(&params[0]) == Some(&BaseType::Int) => format!(
+                "call %ref @_Jrt_stringbuilder_append_int(%ref {}, i32 {})",
+                OpVal(receiver),
+                OpVal(&expr.args[0])
+            ),
+            ("append", 1) if base_param(&params[0]) == Some(&BaseType::Long) => format!(
+                "call %ref @_Jrt_stringbuilder_append_long(%ref {}, i64 {})",
+                OpVal(receiver),
+                OpVal(&expr.args[0])
+            ),
+            ("append", 1) if base_param(&params[0]) == Some(&BaseType::Char) => {
+                // chars are int-typed on the operand stack; the runtime
+                // takes the 16-bit code unit and utf-8 encodes it
+                let tmp_char = self.var_id_gen.gen();
+                writeln!(
+                    self.out,
+                    "  %t{} = trunc i32 {} to i16",
+                    tmp_char,
+                    OpVal(&expr.args[0])
+                )?;
+                format!(
+                    "call %ref @_Jrt_stringbuilder_append_char(%ref {}, i16 %t{})",
+                    OpVal(receiver),
+                    tmp_char
+                )
+            }
+            ("toString", 0) => format!(
+                "call %ref @_Jrt_stringbuilder_to_string(%ref {})",
+                OpVal(receiver)
+            ),
+            _ => return Ok(false),
+        };
+        if let Dest::Assign(assign) = dest {
+            writeln!(self.out, "  {} = {}", assign, call)?;
+        } else if &**method_name == "append" {
+            // append mutates the builder, so the call survives even
+            // when the chained value is discarded
+            writeln!(self.out, "  {}", call)?;
+        }
+        Ok(true)
+    }
+
     fn gen_expr_monitor(&mut self, op: &Op, transition: &MonitorStateTransition) -> Fallible<()> {
         match transition {
             MonitorStateTransition::Enter => {
@@ -377,18 +694,58 @@ impl<'a> ExprCodeGen<'a> {
 
     fn gen_expr_array_new(&mut self, ctyp: &Type, count: &Op, dest: Dest) -> Fallible<()> {
         if let Dest::Assign(assign) = dest {
-            let component_type = tlt_array_component_type(ctyp);
+            // the component width is statically known here, so use the
+            // width-specialized entry points
+            let entry_point = match ctyp {
+                Type::Boolean | Type::Byte | Type::Char => "_Jrt_array_new_1",
+                Type::Short => "_Jrt_array_new_2",
+                Type::Int | Type::Float => "_Jrt_array_new_4",
+                Type::Long | Type::Double => "_Jrt_array_new_8",
+                Type::Reference => "_Jrt_array_new_ref",
+            };
             writeln!(
                 self.out,
-                "  {} = call %ref @_Jrt_array_new(i32 {count}, i64 {width})",
+                "  {} = call %ref @{entry_point}(i32 {count})",
                 assign,
-                count = OpVal(count),
-                width = GenSizeOf(&component_type)
+                entry_point = entry_point,
+                count = OpVal(count)
             )?;
         }
         Ok(())
     }
 
+    fn gen_expr_array_new_multi(
+        &mut self,
+        ctyp: &Type,
+        counts: &[Op],
+        dest: Dest,
+    ) -> Fallible<()> {
+        if let Dest::Assign(assign) = dest {
+            // the runtime lays out the whole nest in a single block;
+            // reference leaves pass width 0 so generated code doesn't
+            // hardcode the runtime's ref size
+            let leaf_width = match ctyp {
+                Type::Boolean | Type::Byte | Type::Char => 1,
+                Type::Short => 2,
+                Type::Int | Type::Float => 4,
+                Type::Long | Type::Double => 8,
+                Type::Reference => 0,
+            };
+            write!(
+                self.out,
+                "  {} = call %ref (i64, i32, ...) @_Jrt_array_new_multi(i64 {}, i32 {}",
+                assign,
+                leaf_width,
+                counts.len()
+            )?;
+            for count in counts.iter() {
+                write!(self.out, ", i32 {}", OpVal(count))?;
+            }
+            writeln!(self.out, ")")?;
+        }
+        Ok(())
+    }
+
     fn gen_expr_array_length(&mut self, aref: &Op, dest: Dest) -> Fallible<()> {
         if let Dest::Assign(assign) = dest {
             writeln!(
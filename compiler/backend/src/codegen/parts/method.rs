@@ -1,8 +1,10 @@
+use std::collections::BTreeMap;
 use std::fmt::{self, Write};
 use std::sync::Arc;
 
 use classfile::{ClassFile, ConstantPool, Method};
 use failure::Fallible;
+use strbuf::StrBuf;
 
 use frontend::blocks::{BlockGraph, PhiOperand, PhiOperandSource};
 use frontend::classes::ClassGraph;
@@ -14,6 +16,7 @@ use crate::codegen::Target;
 use crate::layout::{FieldLayoutMap, VTableMap};
 use crate::mangle;
 
+use super::escape;
 use super::expr::ExprCodeGen;
 
 pub struct MethodCodeGen<'a> {
@@ -53,9 +56,29 @@ impl<'a> MethodCodeGen<'a> {
             args = gen_args.gen_comma_sep(|(_, op)| GenOpWithType(op))
         )?;
         writeln!(self.out, "entry:")?;
+        let stack_allocs = escape::stack_allocatable(blocks, consts);
+        for (var_id, alloc_class_name) in stack_allocs.iter() {
+            // each slot reserves 16 bytes for the object header in
+            // front of the fields; api/object.c asserts that this
+            // covers sizeof(struct object_base)
+            let object_type = self.decls.add_object_type(alloc_class_name)?;
+            writeln!(
+                self.out,
+                "  %s{id} = alloca {{ [16 x i8], {otyp} }}",
+                id = var_id,
+                otyp = object_type
+            )?;
+            writeln!(
+                self.out,
+                "  %sp{id} = bitcast {{ [16 x i8], {otyp} }}* %s{id} to i8*",
+                id = var_id,
+                otyp = object_type
+            )?;
+        }
+        self.gen_safepoint_poll()?;
         writeln!(self.out, "  br label %B0")?;
         for block in blocks.blocks() {
-            self.gen_block(block, blocks, consts)?;
+            self.gen_block(block, blocks, consts, &stack_allocs)?;
         }
         writeln!(self.out, "}}")?;
         Ok(())
@@ -66,11 +89,12 @@ impl<'a> MethodCodeGen<'a> {
         block: &BasicBlock,
         blocks: &BlockGraph,
         consts: &ConstantPool,
+        stack_allocs: &BTreeMap<u64, StrBuf>,
     ) -> Fallible<()> {
         writeln!(self.out, "B{}:", block.address)?;
         self.gen_phi_nodes(block, blocks)?;
         for stmt in block.statements.iter() {
-            self.gen_statement(stmt, consts)?;
+            self.gen_statement(stmt, consts, stack_allocs)?;
         }
         match &block.branch_stub {
             BranchStub::Return(ret_opt) => {
@@ -85,7 +109,17 @@ impl<'a> MethodCodeGen<'a> {
                     writeln!(self.out, "  ret void")?;
                 }
             }
-            BranchStub::Switch(switch) => self.gen_switch(switch)?,
+            BranchStub::Switch(switch) => {
+                // a branch back to an earlier address closes a loop;
+                // poll there so an armed safepoint can't be outrun by
+                // a hot loop that never calls out
+                let backward = switch.default <= block.address
+                    || switch.cases.iter().any(|(_, addr)| *addr <= block.address);
+                if backward {
+                    self.gen_safepoint_poll()?;
+                }
+                self.gen_switch(switch)?
+            }
             BranchStub::Throw(var) => {
                 writeln!(
                     self.out,
@@ -98,6 +132,19 @@ impl<'a> MethodCodeGen<'a> {
         Ok(())
     }
 
+    // the safepoint poll: a volatile byte load from the runtime's
+    // poll page, an L1 hit until the runtime arms the page by
+    // protecting it (see runtime/lib/safepoint.h)
+    fn gen_safepoint_poll(&mut self) -> Fallible<()> {
+        let tmp = self.var_id_gen.gen();
+        writeln!(
+            self.out,
+            "  %t{} = load volatile i8, i8* getelementptr inbounds ([4096 x i8], [4096 x i8]* @_Jrt_safepoint_page, i64 0, i64 0)",
+            tmp
+        )?;
+        Ok(())
+    }
+
     fn gen_switch(&mut self, switch: &Switch) -> Fallible<()> {
         write!(
             self.out,
@@ -112,17 +159,28 @@ impl<'a> MethodCodeGen<'a> {
         Ok(())
     }
 
-    fn gen_statement(&mut self, stmt: &Statement, consts: &ConstantPool) -> Fallible<()> {
+    fn gen_statement(
+        &mut self,
+        stmt: &Statement,
+        consts: &ConstantPool,
+        stack_allocs: &BTreeMap<u64, StrBuf>,
+    ) -> Fallible<()> {
         let dest;
         if let Some(ref var) = stmt.assign {
             dest = Dest::Assign(DestAssign::Var(var.clone()));
         } else {
             dest = Dest::Ignore;
         }
-        self.gen_expr(&stmt.expression, consts, dest)
+        self.gen_expr(&stmt.expression, consts, dest, stack_allocs)
     }
 
-    fn gen_expr(&mut self, expr: &Expr, consts: &ConstantPool, dest: Dest) -> Fallible<()> {
+    fn gen_expr(
+        &mut self,
+        expr: &Expr,
+        consts: &ConstantPool,
+        dest: Dest,
+        stack_allocs: &BTreeMap<u64, StrBuf>,
+    ) -> Fallible<()> {
         let mut expr_code_gen = ExprCodeGen {
             out: self.out,
             decls: self.decls,
@@ -132,6 +190,7 @@ impl<'a> MethodCodeGen<'a> {
             field_layouts: self.field_layouts,
             var_id_gen: self.var_id_gen,
             target: self.target,
+            stack_allocs,
         };
         expr_code_gen.gen_expr(expr, consts, dest)
     }
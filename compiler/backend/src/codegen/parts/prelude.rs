@@ -45,6 +45,10 @@ impl<'a> PreludeCodeGen<'a> {
             "declare i32 @_Jrt_start(i32, i8**, void (%ref) *)"
         )?;
         writeln!(self.out, "declare %ref @_Jrt_object_new(i64, i8*)")?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_object_init_onstack(i8*, i64, i8*)"
+        )?;
         writeln!(self.out, "declare i8* @_Jrt_object_field_ptr(%ref)")?;
         writeln!(
             self.out,
@@ -57,11 +61,72 @@ impl<'a> PreludeCodeGen<'a> {
         writeln!(self.out, "declare void @_Jrt_object_monitorenter(%ref)")?;
         writeln!(self.out, "declare void @_Jrt_object_monitorexit(%ref)")?;
         writeln!(self.out, "declare %ref @_Jrt_array_new(i32, i64)")?;
+        writeln!(self.out, "declare %ref @_Jrt_array_new_1(i32)")?;
+        writeln!(self.out, "declare %ref @_Jrt_array_new_2(i32)")?;
+        writeln!(self.out, "declare %ref @_Jrt_array_new_4(i32)")?;
+        writeln!(self.out, "declare %ref @_Jrt_array_new_8(i32)")?;
+        writeln!(self.out, "declare %ref @_Jrt_array_new_ref(i32)")?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_array_new_multi(i64, i32, ...)"
+        )?;
         writeln!(self.out, "declare i32 @_Jrt_array_length(%ref)")?;
         writeln!(self.out, "declare i8* @_Jrt_array_element_ptr(%ref)")?;
+        writeln!(
+            self.out,
+            "declare void @_Jrt_array_fill_1(%ref, i32, i32, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare void @_Jrt_array_fill_2(%ref, i32, i32, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare void @_Jrt_array_fill_4(%ref, i32, i32, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare void @_Jrt_array_fill_8(%ref, i32, i32, i64)"
+        )?;
+        writeln!(self.out, "declare i32 @_Jrt_array_equals(%ref, %ref)")?;
+        writeln!(self.out, "declare i32 @_Jrt_array_hash(%ref)")?;
         writeln!(self.out, "declare void @_Jrt_throw(%ref) noreturn")?;
         writeln!(self.out, "declare void @_Jrt_abstract() noreturn")?;
-        writeln!(self.out, "declare %ref @_Jrt_ldstr(i8*)")?;
+        writeln!(
+            self.out,
+            "@_Jrt_safepoint_page = external global [4096 x i8]"
+        )?;
+        writeln!(self.out, "declare %ref @_Jrt_ldstr_cached(i8*, i8**)")?;
+        writeln!(self.out, "declare %ref @_Jrt_string_intern(%ref)")?;
+        writeln!(self.out, "declare i32 @_Jrt_string_hash(%ref)")?;
+        writeln!(
+            self.out,
+            "declare i32 @_Jrt_string_index_of(%ref, %ref, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare i32 @_Jrt_string_index_of_char(%ref, i32, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_stringbuilder_append_string(%ref, %ref)"
+        )?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_stringbuilder_append_int(%ref, i32)"
+        )?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_stringbuilder_append_long(%ref, i64)"
+        )?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_stringbuilder_append_char(%ref, i16)"
+        )?;
+        writeln!(
+            self.out,
+            "declare %ref @_Jrt_stringbuilder_to_string(%ref)"
+        )?;
 
         for index in self.class.constant_pool.indices() {
             if let Constant::String(string_const) =
@@ -72,11 +137,19 @@ impl<'a> PreludeCodeGen<'a> {
                 let utf8 = self.class.constant_pool.get_utf8(utf8_index).unwrap();
                 writeln!(
                     self.out,
-                    "@.str{} = internal constant [{} x i8] {}",
+                    "@.str{} = internal constant [{} x i8] {}, section \"jrt_metadata\"",
                     utf8_index.into_u16(),
                     utf8.len() + 1,
                     GenStringConst(&*utf8)
                 )?;
+                // per-site intern cache slot, filled by _Jrt_ldstr_cached
+                // on first execution; lives in the data segment, which
+                // the collector scans as roots
+                writeln!(
+                    self.out,
+                    "@.strc{} = internal global i8* null",
+                    utf8_index.into_u16()
+                )?;
             }
         }
         Ok(())
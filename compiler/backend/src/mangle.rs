@@ -92,6 +92,20 @@ pub fn mangle_vtable_name(class_name: &str) -> String {
     mangler.output
 }
 
+pub fn mangle_class_metadata_name(class_name: &str) -> String {
+    let mut mangler = Mangler::new();
+
+    mangler.output.push_str("TI");
+
+    mangler.nested_start();
+    for ns in class_name.split('/') {
+        mangler.name(&ns);
+    }
+    mangler.nested_end();
+
+    mangler.output
+}
+
 struct Mangler {
     output: String,
 }
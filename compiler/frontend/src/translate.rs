@@ -175,6 +175,7 @@ pub enum Expr {
     Compare(CompareExpr),
     Binary(BinaryExpr),
     ArrayNew(Type, Op),
+    ArrayNewMulti(Type, Vec<Op>),
     ArrayLength(Op),
     ArrayLoad(Type, Op, Op),
     ArrayStore(Type, Op, Op, Op),
@@ -500,6 +501,39 @@ impl<'a> TranslateInstr<'a> {
         self.stmts.push(statement);
     }
 
+    fn array_new_multi(&mut self, idx: u16, dims: u8) {
+        let class = self.consts.get_class(ConstantIndex::from_u16(idx)).unwrap();
+        let class_name = self.consts.get_utf8(class.name_index).unwrap();
+        // the class constant holds the full array descriptor (e.g.
+        // "[[I"); the character behind the requested dimensions is the
+        // component of the innermost arrays this instruction allocates
+        let component = match class_name.as_bytes()[dims as usize] {
+            b'Z' => Type::Boolean,
+            b'B' => Type::Byte,
+            b'C' => Type::Char,
+            b'S' => Type::Short,
+            b'I' => Type::Int,
+            b'F' => Type::Float,
+            b'J' => Type::Long,
+            b'D' => Type::Double,
+            _ => Type::Reference, // 'L', or '[' for partial allocation
+        };
+        let mut counts = Vec::with_capacity(dims as usize);
+        for _ in 0..dims {
+            counts.push(self.state.pop());
+        }
+        // popped innermost-first; the expression holds them
+        // outermost-first
+        counts.reverse();
+        let var = self.var_id_gen.gen(Type::Reference);
+        self.state.push(Op::Var(var.clone()));
+        let statement = Statement {
+            assign: Some(var),
+            expression: Expr::ArrayNewMulti(component, counts),
+        };
+        self.stmts.push(statement);
+    }
+
     fn array_length(&mut self) {
         let arrayref = self.state.pop();
         let var = self.var_id_gen.gen(Type::Int);
@@ -775,6 +809,7 @@ fn translate_instructions(
             // array operations
             Instr::ANewArray(_) => t.array_new(Type::Reference),
             Instr::NewArray(atype) => t.array_new(Type::from_array_type(atype)),
+            Instr::MultiNewArray(idx, dims) => t.array_new_multi(*idx, *dims),
             Instr::ArrayLength => t.array_length(),
             Instr::AaLoad => t.array_load(Type::Reference),
             Instr::BaLoad => t.array_load(Type::Byte),
@@ -3,6 +3,9 @@ use std::fs;
 use std::io::Write;
 use std::path::{Path, PathBuf};
 use std::process::Command;
+use std::sync::mpsc;
+use std::sync::{Arc, Mutex};
+use std::thread;
 
 use classfile::ClassFile;
 use failure::{bail, Fallible};
@@ -64,11 +67,52 @@ impl Driver {
             data_layout: self.machine.data_layout().to_string_rep().to_string(),
         };
         let codegen = CodeGen::try_new(classes.clone(), target)?;
-        let mut compiler = Compiler::new(classes.clone(), codegen);
 
-        for class_name in class_names {
-            let module = compiler.compile(&class_name, &*class_name == main)?;
-            self.modules.insert(class_name.to_string(), module);
+        // per-class compilation is independent: the class graph and
+        // the layout caches inside CodeGen are shared behind
+        // Arc<Mutex>, so classes are handed out from a shared queue
+        // to one worker per core and the emitted modules collected
+        // over a channel
+        let jobs = job_count(class_names.len());
+        let queue = Arc::new(Mutex::new(class_names));
+        let (sender, receiver) = mpsc::channel();
+        let mut workers = Vec::with_capacity(jobs);
+        for _ in 0..jobs {
+            let queue = Arc::clone(&queue);
+            let sender = sender.clone();
+            let mut compiler = Compiler::new(classes.clone(), codegen.clone());
+            let main = main.to_owned();
+            workers.push(thread::spawn(move || loop {
+                let class_name = match queue.lock().unwrap().pop() {
+                    Some(class_name) => class_name,
+                    None => break,
+                };
+                let result = compiler.compile(&class_name, &*class_name == main);
+                if sender.send((class_name, result)).is_err() {
+                    break;
+                }
+            }));
+        }
+        drop(sender);
+
+        let mut first_error = None;
+        for (class_name, result) in receiver {
+            match result {
+                Ok(module) => {
+                    self.modules.insert(class_name.to_string(), module);
+                }
+                Err(err) => {
+                    if first_error.is_none() {
+                        first_error = Some(err);
+                    }
+                }
+            }
+        }
+        for worker in workers {
+            worker.join().expect("compiler worker panicked");
+        }
+        if let Some(err) = first_error {
+            return Err(err);
         }
 
         Ok(())
@@ -84,27 +128,26 @@ impl Driver {
     }
 
     pub fn link(&self, runtime_path: &Path, output_path: &Path) -> Fallible<()> {
-        let mut main = llvm::Module::new("main");
+        // a bitcode runtime (`make bitcode`) is linked at the IR level
+        // before optimization, so the trivial _Jrt_ helpers can inline
+        // into the generated code; that whole-program pass needs a
+        // single module, so parallel codegen only applies to the
+        // archive runtime
+        let runtime_bitcode = runtime_path.extension().map_or(false, |ext| ext == "bc");
 
-        for (_name, module) in self.modules.iter() {
-            main.link(llvm::Module::parse_ir(module.as_bytes())?)?;
-        }
-
-        let mut pass_manager_builder = llvm::transform::PassManagerBuilder::new();
-        if self.optimize {
-            pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O3);
+        let objects = if runtime_bitcode {
+            vec![self.emit_merged(runtime_path)?]
         } else {
-            pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O0);
-        }
-        let pass_manager = pass_manager_builder.build();
+            self.emit_parallel()?
+        };
 
-        pass_manager.run(&mut main);
-        let main_obj = self
-            .machine
-            .emit_to_buffer(&main, llvm::codegen::FileType::Object)?;
-        let mut main_out = tempfile::Builder::new().suffix(".o").tempfile()?;
-        main_out.write_all(&main_obj)?;
-        main_out.flush()?;
+        let mut object_files = Vec::with_capacity(objects.len());
+        for object in objects {
+            let mut file = tempfile::Builder::new().suffix(".o").tempfile()?;
+            file.write_all(&object)?;
+            file.flush()?;
+            object_files.push(file);
+        }
 
         let mut cmd = Command::new("cc");
 
@@ -113,8 +156,12 @@ impl Driver {
             cmd.env_remove("DYLD_LIBRARY_PATH");
         }
 
-        cmd.arg(main_out.path());
-        cmd.arg(runtime_path);
+        for file in object_files.iter() {
+            cmd.arg(file.path());
+        }
+        if !runtime_bitcode {
+            cmd.arg(runtime_path);
+        }
         cmd.arg("-o");
         cmd.arg(output_path);
         cmd.args(&["-lpthread", "-ldl"]);
@@ -140,4 +187,114 @@ impl Driver {
 
         Ok(())
     }
+
+    // single-module path: everything (including the runtime bitcode)
+    // is merged into one module so the whole-program LTO passes see
+    // the full call graph
+    fn emit_merged(&self, runtime_path: &Path) -> Fallible<Vec<u8>> {
+        let mut main = llvm::Module::new("main");
+
+        for (_name, module) in self.modules.iter() {
+            main.link(llvm::Module::parse_ir(module.as_bytes())?)?;
+        }
+
+        let bytes = fs::read(runtime_path)?;
+        main.link(llvm::Module::parse_bitcode(&bytes)?)?;
+
+        let mut pass_manager_builder = llvm::transform::PassManagerBuilder::new();
+        if self.optimize {
+            pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O3);
+        } else {
+            pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O0);
+        }
+        let pass_manager = pass_manager_builder.build();
+
+        pass_manager.run(&mut main);
+        let main_obj = self
+            .machine
+            .emit_to_buffer(&main, llvm::codegen::FileType::Object)?;
+        Ok(main_obj.to_vec())
+    }
+
+    // ThinLTO-style parallel codegen: the class modules are split
+    // into one bucket per core, and each worker optimizes and emits
+    // its bucket in a private LLVM context; the final link over
+    // object files is cheap and left to the system linker
+    fn emit_parallel(&self) -> Fallible<Vec<Vec<u8>>> {
+        let jobs = job_count(self.modules.len());
+        let mut buckets: Vec<Vec<String>> = (0..jobs).map(|_| Vec::new()).collect();
+        for (i, (_name, module)) in self.modules.iter().enumerate() {
+            buckets[i % jobs].push(module.clone());
+        }
+
+        let (sender, receiver) = mpsc::channel();
+        let mut workers = Vec::with_capacity(jobs);
+        for bucket in buckets {
+            let sender = sender.clone();
+            let optimize = self.optimize;
+            workers.push(thread::spawn(move || {
+                let _ = sender.send(emit_bucket(bucket, optimize));
+            }));
+        }
+        drop(sender);
+
+        let mut objects = Vec::with_capacity(jobs);
+        let mut first_error = None;
+        for result in receiver {
+            match result {
+                Ok(object) => objects.push(object),
+                Err(err) => {
+                    if first_error.is_none() {
+                        first_error = Some(err);
+                    }
+                }
+            }
+        }
+        for worker in workers {
+            worker.join().expect("codegen worker panicked");
+        }
+        if let Some(err) = first_error {
+            return Err(err);
+        }
+
+        Ok(objects)
+    }
+}
+
+fn job_count(work_items: usize) -> usize {
+    llvm::support::host_num_physical_cores()
+        .unwrap_or(1)
+        .min(work_items)
+        .max(1)
+}
+
+fn emit_bucket(modules: Vec<String>, optimize: bool) -> Fallible<Vec<u8>> {
+    let context = llvm::Context::new();
+    let mut merged = llvm::Module::new_in(&context, "bucket");
+    for module in modules.iter() {
+        merged.link(llvm::Module::parse_ir_in(&context, module.as_bytes())?)?;
+    }
+
+    // no whole-program passes here: symbols in this bucket may be
+    // referenced from other buckets and must stay external
+    let mut pass_manager_builder = llvm::transform::PassManagerBuilder::new();
+    if optimize {
+        pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O3);
+    } else {
+        pass_manager_builder.set_opt_level(llvm::transform::OptLevel::O0);
+    }
+    let pass_manager = pass_manager_builder.build_per_module();
+    pass_manager.run(&mut merged);
+
+    // target machines are cheap and not synchronized; build one per
+    // worker with the same settings the driver uses
+    let mut machine_builder = llvm::codegen::TargetMachine::builder();
+    machine_builder.set_reloc_mode(llvm::codegen::RelocMode::PIC);
+    if optimize {
+        machine_builder.set_opt_level(llvm::codegen::OptLevel::Aggressive);
+    }
+    let machine = machine_builder.build()?;
+
+    let object = machine.emit_to_buffer(&merged, llvm::codegen::FileType::Object)?;
+    Ok(object.to_vec())
 }
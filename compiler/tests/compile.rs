@@ -16,5 +16,9 @@ cases! {
     fields,
     array,
     interfaces,
-    sync_block
+    sync_block,
+    string_builder,
+    array_bulk,
+    string_intrinsics,
+    multi_array
 }
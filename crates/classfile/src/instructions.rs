@@ -486,7 +486,9 @@ impl Disassembler {
             0x83 => Instr::LXor,
             0xc2 => Instr::MonitorEnter,
             0xc3 => Instr::MonitorExit,
-            0xc5 => unimplemented!("TODO: decode multianewarray"),
+            0xc5 => {
+                Instr::MultiNewArray(self.code.read_u16::<BigEndian>()?, self.code.read_u8()?)
+            }
             0xbb => Instr::New(self.code.read_u16::<BigEndian>()?),
             0xbc => Instr::NewArray(self.decode_array_type()?),
             0x00 => Instr::Nop,
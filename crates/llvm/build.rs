@@ -3,8 +3,10 @@ fn main() {
 
     cc::Build::new()
         .file("wrappers/triple.cpp")
+        .file("wrappers/support.cpp")
+        .file("wrappers/devirt.cpp")
         .opt_level(3)
         .cpp(true)
         .flag("-std=c++14")
-        .compile("triplewrappers");
+        .compile("llvmwrappers");
 }
@@ -0,0 +1,25 @@
+use llvm_sys::core::*;
+use llvm_sys::prelude::*;
+
+// LLVM contexts are not internally synchronized, but distinct
+// contexts are fully independent: every codegen thread creates its
+// own and keeps all modules parsed into it on that thread.
+pub struct Context {
+    pub(crate) llref: LLVMContextRef,
+}
+
+impl Context {
+    pub fn new() -> Self {
+        let llref;
+        unsafe {
+            llref = LLVMContextCreate();
+        }
+        Context { llref }
+    }
+}
+
+impl Drop for Context {
+    fn drop(&mut self) {
+        unsafe { LLVMContextDispose(self.llref) }
+    }
+}
@@ -1,12 +1,15 @@
 mod buffer;
+mod context;
 mod error;
 mod message;
 mod module;
 
 pub use crate::buffer::MemoryBuffer;
+pub use crate::context::Context;
 pub use crate::error::Error;
 pub use crate::message::Message;
 pub use crate::module::Module;
 
 pub mod codegen;
+pub mod support;
 pub mod transform;
@@ -2,6 +2,7 @@ use std::ffi::CStr;
 use std::ptr;
 
 use libc::c_char;
+use llvm_sys::bit_reader::*;
 use llvm_sys::bit_writer::*;
 use llvm_sys::core::*;
 use llvm_sys::ir_reader::*;
@@ -9,6 +10,7 @@ use llvm_sys::linker::*;
 use llvm_sys::prelude::*;
 
 use crate::buffer::MemoryBuffer;
+use crate::context::Context;
 use crate::error::Error;
 
 pub struct Module {
@@ -28,6 +30,18 @@ impl Module {
         Module { llref }
     }
 
+    pub fn new_in(context: &Context, name: &str) -> Self {
+        let llref;
+
+        unsafe {
+            llref = LLVMModuleCreateWithNameInContext(ptr::null(), context.llref);
+            LLVMSetModuleIdentifier(llref, name.as_ptr() as *const c_char, name.len());
+            LLVMSetSourceFileName(llref, name.as_ptr() as *const c_char, name.len());
+        };
+
+        Module { llref }
+    }
+
     pub fn parse_ir(bytes: &[u8]) -> Result<Self, Error> {
         unsafe {
             let ctx = LLVMGetGlobalContext();
@@ -53,6 +67,51 @@ impl Module {
         }
     }
 
+    pub fn parse_ir_in(context: &Context, bytes: &[u8]) -> Result<Self, Error> {
+        unsafe {
+            let buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+                bytes.as_ptr() as *const i8,
+                bytes.len(),
+                ptr::null(),
+            );
+            let mut llref = LLVMModuleCreateWithNameInContext(ptr::null(), context.llref);
+            let mut msg_ptr = ptr::null_mut();
+            let code = LLVMParseIRInContext(
+                context.llref,
+                buf,
+                &mut llref as *mut LLVMModuleRef,
+                &mut msg_ptr as *mut *mut c_char,
+            );
+            if code == 0 {
+                Ok(Module { llref })
+            } else {
+                let message = CStr::from_ptr(msg_ptr).to_string_lossy().into_owned();
+                Err(Error { message })
+            }
+        }
+    }
+
+    pub fn parse_bitcode(bytes: &[u8]) -> Result<Self, Error> {
+        unsafe {
+            let ctx = LLVMGetGlobalContext();
+            let buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+                bytes.as_ptr() as *const i8,
+                bytes.len(),
+                ptr::null(),
+            );
+            let mut llref = ptr::null_mut();
+            let code = LLVMParseBitcodeInContext2(ctx, buf, &mut llref as *mut LLVMModuleRef);
+            LLVMDisposeMemoryBuffer(buf);
+            if code == 0 {
+                Ok(Module { llref })
+            } else {
+                Err(Error {
+                    message: "bitcode parse error".into(),
+                })
+            }
+        }
+    }
+
     pub fn set_source_file_name(&mut self, source_file_name: &str) {
         unsafe {
             LLVMSetSourceFileName(
@@ -0,0 +1,19 @@
+use libc::c_uint;
+
+/// Number of physical cores on the host, or `None` when LLVM cannot
+/// determine it.
+pub fn host_num_physical_cores() -> Option<usize> {
+    let cores;
+    unsafe {
+        cores = LLVMGetHostNumPhysicalCores();
+    }
+    if cores == 0 {
+        None
+    } else {
+        Some(cores as usize)
+    }
+}
+
+extern "C" {
+    fn LLVMGetHostNumPhysicalCores() -> c_uint;
+}
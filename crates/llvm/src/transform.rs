@@ -45,11 +45,28 @@ impl PassManagerBuilder {
         let llref;
         unsafe {
             llref = LLVMCreatePassManager();
+            // devirtualize _Jrt_ dispatch helpers first, so the
+            // populated pipeline can fold and inline the direct calls
+            LLVMAddJrtDevirtualizePass(llref);
             LLVMPassManagerBuilderPopulateModulePassManager(self.llref, llref);
             LLVMPassManagerBuilderPopulateLTOPassManager(self.llref, llref, 1, 1);
         }
         PassManager { llref }
     }
+
+    /// Like `build`, but without the whole-program LTO passes: those
+    /// internalize everything not reachable from `main`, which is
+    /// wrong for a module that other modules link against at the
+    /// object level.
+    pub fn build_per_module(self) -> PassManager {
+        let llref;
+        unsafe {
+            llref = LLVMCreatePassManager();
+            LLVMAddJrtDevirtualizePass(llref);
+            LLVMPassManagerBuilderPopulateModulePassManager(self.llref, llref);
+        }
+        PassManager { llref }
+    }
 }
 
 impl Drop for PassManagerBuilder {
@@ -85,3 +102,7 @@ impl Drop for PassManager {
         }
     }
 }
+
+extern "C" {
+    fn LLVMAddJrtDevirtualizePass(pass_manager: LLVMPassManagerRef);
+}
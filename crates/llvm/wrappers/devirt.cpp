@@ -0,0 +1,172 @@
+// Devirtualization of the runtime's dispatch helpers.
+//
+// Generated code funnels all virtual and interface dispatch through
+// _Jrt_object_vtable_lookup / _Jrt_object_itable_lookup, even when
+// the receiver's vtable is a compile-time constant (a fresh
+// _Jrt_object_new or _Jrt_object_init_onstack result, or a ref
+// aggregate built from a constant). This pass folds such lookups
+// into the method pointer straight out of the vtable constant; the
+// regular pipeline's instcombine then turns the bitcast-and-call
+// into a direct call, which unlocks inlining of the callee.
+
+#include <llvm-c/Types.h>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Pass.h>
+
+using namespace llvm;
+
+namespace {
+
+// Walks a ref value ({ i8* object, i8* vtable }) back to a provably
+// constant vtable pointer, or null when the receiver is polymorphic.
+Constant *refVTableConstant(Value *ref, unsigned depth = 0) {
+    if (depth > 8)
+        return nullptr;
+    // refs are assembled with insertvalue; field 1 is the vtable
+    if (auto *insert = dyn_cast<InsertValueInst>(ref)) {
+        if (insert->getNumIndices() == 1 && insert->getIndices()[0] == 1)
+            return dyn_cast<Constant>(insert->getInsertedValueOperand());
+        return refVTableConstant(insert->getAggregateOperand(), depth + 1);
+    }
+    // fresh allocations carry their vtable as an argument
+    if (auto *call = dyn_cast<CallInst>(ref)) {
+        Function *callee = call->getCalledFunction();
+        if (callee == nullptr)
+            return nullptr;
+        StringRef name = callee->getName();
+        if (name == "_Jrt_object_new")
+            return dyn_cast<Constant>(call->getArgOperand(1));
+        if (name == "_Jrt_object_init_onstack")
+            return dyn_cast<Constant>(call->getArgOperand(2));
+        return nullptr;
+    }
+    if (auto *constant = dyn_cast<Constant>(ref))
+        return constant->getAggregateElement(1u);
+    return nullptr;
+}
+
+// Resolves an i8* cast of a vtable global back to the global, which
+// must be a constant with a visible initializer for folding.
+GlobalVariable *vtableGlobal(Constant *vtable) {
+    auto *global = dyn_cast<GlobalVariable>(vtable->stripPointerCasts());
+    if (global == nullptr || !global->isConstant() || !global->hasDefinitiveInitializer())
+        return nullptr;
+    return global;
+}
+
+// Vtable constant layout (see backend's gen_vtable_const):
+//   field 0           i32 method count
+//   field 1           i8* class metadata
+//   fields 2 .. 2+M-1 method pointers
+//   field 2+M         i32 interface count
+//   fields 2+M+1 ...  (interface vtable, i32 method offset) pairs
+Constant *methodAt(Constant *init, uint64_t field, Type *type) {
+    Constant *method = init->getAggregateElement((unsigned)field);
+    if (method == nullptr || !method->getType()->isPointerTy() ||
+        !method->getType()->getPointerElementType()->isFunctionTy())
+        return nullptr;
+    return ConstantExpr::getBitCast(method, type);
+}
+
+Constant *resolveVirtual(CallInst *call) {
+    Constant *vtable = refVTableConstant(call->getArgOperand(0));
+    auto *index = dyn_cast<ConstantInt>(call->getArgOperand(1));
+    if (vtable == nullptr || index == nullptr)
+        return nullptr;
+    GlobalVariable *global = vtableGlobal(vtable);
+    if (global == nullptr)
+        return nullptr;
+    return methodAt(global->getInitializer(), 2 + index->getZExtValue(),
+                    call->getType());
+}
+
+Constant *resolveInterface(CallInst *call) {
+    Constant *vtable = refVTableConstant(call->getArgOperand(0));
+    auto *iface = dyn_cast<Constant>(call->getArgOperand(1));
+    auto *index = dyn_cast<ConstantInt>(call->getArgOperand(2));
+    if (vtable == nullptr || iface == nullptr || index == nullptr)
+        return nullptr;
+    GlobalVariable *global = vtableGlobal(vtable);
+    if (global == nullptr)
+        return nullptr;
+    Constant *init = global->getInitializer();
+
+    auto *count = dyn_cast_or_null<ConstantInt>(init->getAggregateElement(0u));
+    if (count == nullptr)
+        return nullptr;
+    uint64_t icount_field = 2 + count->getZExtValue();
+    auto *icount =
+        dyn_cast_or_null<ConstantInt>(init->getAggregateElement((unsigned)icount_field));
+    if (icount == nullptr)
+        return nullptr;
+
+    // scan the itable like the runtime does, at compile time
+    uint64_t k;
+    for (k = 0; k < icount->getZExtValue(); k++) {
+        Constant *entry_iface =
+            init->getAggregateElement((unsigned)(icount_field + 1 + 2 * k));
+        auto *entry_offset = dyn_cast_or_null<ConstantInt>(
+            init->getAggregateElement((unsigned)(icount_field + 2 + 2 * k)));
+        if (entry_iface == nullptr || entry_offset == nullptr)
+            return nullptr;
+        if (entry_iface->stripPointerCasts() == iface->stripPointerCasts())
+            return methodAt(init, 2 + entry_offset->getZExtValue() + index->getZExtValue(),
+                            call->getType());
+    }
+    return nullptr;
+}
+
+struct JrtDevirtualizePass : public ModulePass {
+    static char ID;
+
+    JrtDevirtualizePass() : ModulePass(ID) {}
+
+    StringRef getPassName() const override {
+        return "Devirtualize _Jrt_ dispatch helpers";
+    }
+
+    bool runOnModule(Module &module) override {
+        bool changed = false;
+        changed |= fold(module.getFunction("_Jrt_object_vtable_lookup"), resolveVirtual);
+        changed |= fold(module.getFunction("_Jrt_object_itable_lookup"), resolveInterface);
+        return changed;
+    }
+
+    bool fold(Function *helper, Constant *(*resolve)(CallInst *)) {
+        if (helper == nullptr)
+            return false;
+        SmallVector<CallInst *, 32> calls;
+        for (User *user : helper->users()) {
+            if (auto *call = dyn_cast<CallInst>(user)) {
+                if (call->getCalledFunction() == helper)
+                    calls.push_back(call);
+            }
+        }
+        bool changed = false;
+        for (CallInst *call : calls) {
+            if (Constant *method = resolve(call)) {
+                call->replaceAllUsesWith(method);
+                call->eraseFromParent();
+                changed = true;
+            }
+        }
+        return changed;
+    }
+};
+
+char JrtDevirtualizePass::ID = 0;
+
+} // namespace
+
+extern "C" {
+    void LLVMAddJrtDevirtualizePass(LLVMPassManagerRef pass_manager) {
+        unwrap(pass_manager)->add(new JrtDevirtualizePass());
+    }
+}
@@ -0,0 +1,8 @@
+#include <llvm/Support/Host.h>
+
+extern "C" {
+    unsigned LLVMGetHostNumPhysicalCores(void) {
+        int cores = llvm::sys::getHostNumPhysicalCores();
+        return cores > 0 ? (unsigned)cores : 0;
+    }
+}
@@ -0,0 +1,172 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "../lib/alloc.h"
+#include "../lib/gc.h"
+#include "../lib/utils.h"
+
+_Thread_local struct alloc_tlab alloc_tlab = {NULL, NULL, NULL, 0};
+
+struct alloc_chunk *alloc_chunks = NULL;
+struct alloc_large *alloc_larges = NULL;
+
+static struct alloc_chunk *alloc_chunks_free = NULL;
+
+static pthread_mutex_t alloc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// the up-front heap reservation; chunks are carved from
+// [heap_cursor, heap_end) under the allocation lock, falling back to
+// per-chunk mmap once it runs out (or if the reservation failed)
+#define ALLOC_HEAP_DEFAULT_SIZE ((size_t)512 * 1024 * 1024)
+#define ALLOC_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+static uint8_t *heap_cursor = NULL;
+static uint8_t *heap_end = NULL;
+
+static size_t alloc_heap_size(void) {
+    const char *env = getenv("JRT_HEAP_SIZE");
+    if (env == NULL || *env == '\0') {
+        return ALLOC_HEAP_DEFAULT_SIZE;
+    }
+    char *suffix;
+    size_t size = (size_t)strtoull(env, &suffix, 10);
+    switch (*suffix) {
+    case 'k':
+    case 'K':
+        size *= 1024;
+        break;
+    case 'm':
+    case 'M':
+        size *= 1024 * 1024;
+        break;
+    case 'g':
+    case 'G':
+        size *= 1024 * 1024 * 1024;
+        break;
+    case '\0':
+        break;
+    default:
+        PANIC("Malformed JRT_HEAP_SIZE (expected e.g. 256m or 4g). Aborting.");
+    }
+    if (size < ALLOC_CHUNK_SIZE) {
+        PANIC("JRT_HEAP_SIZE smaller than one heap chunk. Aborting.");
+    }
+    return size;
+}
+
+void alloc_init(void) {
+    // round up to whole huge pages and over-reserve by one so the
+    // base can be aligned to a huge-page boundary; MAP_NORESERVE
+    // because most of the reservation may never be touched
+    size_t size = (alloc_heap_size() + (ALLOC_HUGE_PAGE_SIZE - 1)) &
+                  ~(ALLOC_HUGE_PAGE_SIZE - 1);
+    void *reservation = mmap(NULL, size + ALLOC_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation == MAP_FAILED) {
+        // not fatal: chunk acquisition falls back to per-chunk mmap
+        return;
+    }
+    uint8_t *base = (uint8_t *)(((uintptr_t)reservation + (ALLOC_HUGE_PAGE_SIZE - 1)) &
+                                ~(uintptr_t)(ALLOC_HUGE_PAGE_SIZE - 1));
+#ifdef MADV_HUGEPAGE
+    // best effort: the reservation works fine on 4K pages if the
+    // kernel has transparent huge pages disabled
+    madvise(base, size, MADV_HUGEPAGE);
+#endif
+    heap_cursor = base;
+    heap_end = base + size;
+}
+
+void alloc_lock(void) {
+    ensure(pthread_mutex_lock(&alloc_mutex));
+}
+
+void alloc_unlock(void) {
+    ensure(pthread_mutex_unlock(&alloc_mutex));
+}
+
+void alloc_tlab_retire(void) {
+    if (alloc_tlab.chunk != NULL) {
+        alloc_tlab.chunk->limit = alloc_tlab.top;
+        alloc_tlab.top = NULL;
+        alloc_tlab.end = NULL;
+        alloc_tlab.chunk = NULL;
+    }
+}
+
+void alloc_chunk_release(struct alloc_chunk *chunk) {
+    chunk->next = alloc_chunks_free;
+    alloc_chunks_free = chunk;
+}
+
+// caller must hold the allocation lock
+static struct alloc_chunk *alloc_chunk_acquire(void) {
+    struct alloc_chunk *chunk = alloc_chunks_free;
+    if (chunk != NULL) {
+        alloc_chunks_free = chunk->next;
+        chunk->recycled = 1;
+    } else if ((size_t)(heap_end - heap_cursor) >= ALLOC_CHUNK_SIZE) {
+        chunk = (struct alloc_chunk *)heap_cursor;
+        heap_cursor += ALLOC_CHUNK_SIZE;
+        chunk->recycled = 0;
+    } else {
+        chunk = mmap(NULL, ALLOC_CHUNK_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (chunk == MAP_FAILED) {
+            PANIC("Failed to allocate heap chunk. Aborting.");
+        }
+        chunk->recycled = 0;
+    }
+    chunk->limit = ALLOC_CHUNK_BLOCKS(chunk);
+    chunk->next = alloc_chunks;
+    alloc_chunks = chunk;
+    return chunk;
+}
+
+void *alloc_slow(size_t size) {
+    // size already includes the block header and alignment (see alloc)
+
+    // oversized requests bypass the TLAB entirely
+    if (size > ALLOC_LARGE_THRESHOLD) {
+        gc_maybe_collect(size);
+        // calloc so large arrays are served from kernel-zeroed pages
+        // instead of paying an explicit memset
+        struct alloc_large *large =
+            calloc(1, sizeof(struct alloc_large) + size - sizeof(struct alloc_block));
+        if (large == NULL) {
+            PANIC("Failed to allocate large object. Aborting.");
+        }
+        large->block.size = (uint32_t)size;
+        large->block.flags = 0;
+        alloc_lock();
+        large->next = alloc_larges;
+        alloc_larges = large;
+        alloc_unlock();
+        return ALLOC_BLOCK_PAYLOAD(&large->block);
+    }
+
+    // refill the TLAB from a fresh chunk, abandoning the tail of the
+    // old one (at most ALLOC_LARGE_THRESHOLD bytes of waste)
+    gc_maybe_collect(ALLOC_CHUNK_SIZE);
+    alloc_lock();
+    alloc_tlab_retire();
+    struct alloc_chunk *chunk = alloc_chunk_acquire();
+    alloc_unlock();
+
+    uint8_t *top = ALLOC_CHUNK_BLOCKS(chunk);
+    alloc_tlab.top = top + size;
+    alloc_tlab.end = ALLOC_CHUNK_END(chunk);
+    alloc_tlab.chunk = chunk;
+    alloc_tlab.zeroed = !chunk->recycled;
+
+    if (!alloc_tlab.zeroed) {
+        memset(top, 0, size);
+    }
+    struct alloc_block *block = (struct alloc_block *)top;
+    block->size = (uint32_t)size;
+    block->flags = 0;
+    return ALLOC_BLOCK_PAYLOAD(block);
+}
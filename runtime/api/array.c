@@ -1,14 +1,173 @@
 #define _GNU_SOURCE 1
+#include <stdarg.h>
 #include <stdint.h>
 #include <stdlib.h>
 
 #include "../lib/ref.h"
 #include "../lib/array.h"
+#include "../lib/profile.h"
+#include "../lib/utils.h"
 
 ref_t _Jrt_array_new(uint32_t count, uint64_t component_size) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * component_size);
     return array_new(count, component_size);
 }
 
+// width-specialized entry points, emitted at newarray/anewarray sites
+// where the component size is statically known; the constant width
+// lets the size computation in array_new fold away
+
+ref_t _Jrt_array_new_1(uint32_t count) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * (uint64_t)1);
+    return array_new(count, 1);
+}
+
+ref_t _Jrt_array_new_2(uint32_t count) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * (uint64_t)2);
+    return array_new(count, 2);
+}
+
+ref_t _Jrt_array_new_4(uint32_t count) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * (uint64_t)4);
+    return array_new(count, 4);
+}
+
+ref_t _Jrt_array_new_8(uint32_t count) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * (uint64_t)8);
+    return array_new(count, 8);
+}
+
+ref_t _Jrt_array_new_ref(uint32_t count) {
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, count * sizeof(ref_t));
+    return array_new(count, sizeof(ref_t));
+}
+
+// builds a ref to an array living inside an already-allocated block,
+// without touching its header
+static inline ref_t array_interior_ref(void *at) {
+#ifdef JRT_COMPRESSED_REFS
+    ref_t ref = {
+        .object = at,
+    };
+#else
+    ref_t ref = {
+        .object = at,
+        .vtable = EXTERN_VTABLE_JAVA_LANG_OBJECT,
+    };
+#endif
+    return ref;
+}
+
+// initializes an array header in place over zeroed block memory,
+// mirroring what object_new + array_new do for a standalone array
+static ref_t array_init_at(void *at, uint32_t length, uint64_t width) {
+    ref_t ref = array_interior_ref(at);
+#ifdef JRT_COMPRESSED_REFS
+    OBJECT_BASE_PTR(ref)->vtable = EXTERN_VTABLE_JAVA_LANG_OBJECT;
+#endif
+    lock_init(&OBJECT_BASE_PTR(ref)->lock);
+    ARRAY_BASE_PTR(ref)->length = length;
+    ARRAY_BASE_PTR(ref)->width = (uint32_t)width;
+    return ref;
+}
+
+// fallback for nests too large to fuse into one block: one
+// allocation per array, recursing a dimension at a time
+static ref_t array_new_multi_slow(uint64_t leaf_width, uint32_t dims,
+                                  const uint32_t *counts) {
+    if (dims == 1) {
+        return array_new(counts[0], leaf_width);
+    }
+    ref_t spine = array_new(counts[0], sizeof(ref_t));
+    ref_t *elements = ARRAY_DATA_PTR(spine, ref_t);
+    uint32_t i;
+    for (i = 0; i < counts[0]; i++) {
+        elements[i] = array_new_multi_slow(leaf_width, dims - 1, counts + 1);
+    }
+    return spine;
+}
+
+#define ARRAY_MULTI_MAX_DIMS 255
+
+// multianewarray: the whole nest — outer spine, interior spines and
+// leaf rows — is laid out breadth-first in a single block, so
+// neighboring rows are contiguous in memory and only one allocation
+// is paid instead of one per row. The collector handles the interior
+// arrays as interior pointers into the block; the one caveat is that
+// a monitor inflated on an interior row is not released when the
+// nest dies, since block finalization only sees the outermost header.
+ref_t _Jrt_array_new_multi(uint64_t leaf_width, uint32_t dims, ...) {
+    if (dims == 0 || dims > ARRAY_MULTI_MAX_DIMS) {
+        PANIC("Multi-dimensional array with %u dimensions. Aborting.", dims);
+    }
+    uint32_t counts[ARRAY_MULTI_MAX_DIMS];
+    va_list args;
+    va_start(args, dims);
+    uint32_t d;
+    for (d = 0; d < dims; d++) {
+        counts[d] = va_arg(args, uint32_t);
+    }
+    va_end(args);
+    // reference leaves arrive as width 0, so generated code doesn't
+    // hardcode sizeof(ref_t)
+    if (leaf_width == 0) {
+        leaf_width = sizeof(ref_t);
+    }
+    if (dims == 1) {
+        PROFILE_ALLOC(PROFILE_ARRAY_NEW, counts[0] * leaf_width);
+        return array_new(counts[0], leaf_width);
+    }
+
+    // per-level sub-array sizes and the nest's overall footprint
+    uint64_t level_size[ARRAY_MULTI_MAX_DIMS];
+    uint64_t total = 0;
+    uint64_t level_count = 1;
+    for (d = 0; d < dims; d++) {
+        uint64_t width = (d == dims - 1) ? leaf_width : sizeof(ref_t);
+        uint64_t size = sizeof(struct object_base) +
+                        sizeof(struct array_base) + counts[d] * width;
+        size = (size + (ALLOC_ALIGNMENT - 1)) &
+               ~(uint64_t)(ALLOC_ALIGNMENT - 1);
+        level_size[d] = size;
+        total += level_count * size;
+        level_count *= counts[d];
+        if (total > UINT32_MAX / 2 || level_count > UINT32_MAX) {
+            // block sizes are 32-bit (struct alloc_block): allocate
+            // per array instead of fusing
+            PROFILE_ALLOC(PROFILE_ARRAY_NEW, total);
+            return array_new_multi_slow(leaf_width, dims, counts);
+        }
+    }
+
+    PROFILE_ALLOC(PROFILE_ARRAY_NEW, total);
+    uint8_t *level_start = alloc((size_t)total);
+    ref_t top = array_interior_ref(level_start);
+    level_count = 1;
+    for (d = 0; d < dims; d++) {
+        uint64_t width = (d == dims - 1) ? leaf_width : sizeof(ref_t);
+        uint8_t *at = level_start;
+        uint8_t *child = level_start + level_count * level_size[d];
+        uint64_t i;
+        for (i = 0; i < level_count; i++) {
+            ref_t array = array_init_at(at, counts[d], width);
+            if (d + 1 < dims) {
+                // element refs point at the next level's arrays, whose
+                // headers the next pass initializes
+                ref_t *elements = ARRAY_DATA_PTR(array, ref_t);
+                uint32_t j;
+                for (j = 0; j < counts[d]; j++) {
+                    elements[j] = array_interior_ref(child);
+                    child += level_size[d + 1];
+                }
+            }
+            at += level_size[d];
+        }
+        level_start = at; // the next level starts where this one ended
+        level_count *= counts[d];
+    }
+    return top;
+}
+
 uint32_t _Jrt_array_length(ref_t ref) {
     return ARRAY_BASE_PTR(ref)->length;
 }
@@ -16,3 +175,159 @@ uint32_t _Jrt_array_length(ref_t ref) {
 void *_Jrt_array_element_ptr(ref_t ref) {
     return ARRAY_DATA_PTR(ref, void);
 }
+
+static void array_fill_out_of_bounds(int32_t from, int32_t to) {
+    // TODO: throw java.lang.ArrayIndexOutOfBoundsException
+    PANIC("Array fill out of bounds (from %d, to %d). Aborting.", from, to);
+}
+
+// negative arguments wrap to huge unsigned values, so two unsigned
+// comparisons cover ordering, bounds and overflow (see arraycopy)
+#define ARRAY_FILL_CHECK(ref, from, to)                                        \
+    do {                                                                       \
+        if (((uint32_t)(from) > (uint32_t)(to)) |                              \
+            ((uint32_t)(to) > ARRAY_BASE_PTR(ref)->length)) {                  \
+            array_fill_out_of_bounds(from, to);                               \
+        }                                                                      \
+    } while (0)
+
+// width-specialized fills, emitted at Arrays.fill call sites with a
+// statically known integral component type; values arrive as their
+// stack type and are truncated to the component width like a plain
+// array store
+
+void _Jrt_array_fill_1(ref_t ref, int32_t from, int32_t to, int32_t value) {
+    ARRAY_FILL_CHECK(ref, from, to);
+    memset(&ARRAY_DATA_PTR(ref, uint8_t)[(uint32_t)from], (uint8_t)value,
+           (uint32_t)(to - from));
+}
+
+JRT_BULKOP void _Jrt_array_fill_2(ref_t ref, int32_t from, int32_t to, int32_t value) {
+    ARRAY_FILL_CHECK(ref, from, to);
+    uint16_t *data = ARRAY_DATA_PTR(ref, uint16_t);
+    uint32_t i;
+    for (i = (uint32_t)from; i < (uint32_t)to; i++) {
+        data[i] = (uint16_t)value;
+    }
+}
+
+JRT_BULKOP void _Jrt_array_fill_4(ref_t ref, int32_t from, int32_t to, int32_t value) {
+    ARRAY_FILL_CHECK(ref, from, to);
+    uint32_t *data = ARRAY_DATA_PTR(ref, uint32_t);
+    uint32_t i;
+    for (i = (uint32_t)from; i < (uint32_t)to; i++) {
+        data[i] = (uint32_t)value;
+    }
+}
+
+JRT_BULKOP void _Jrt_array_fill_8(ref_t ref, int32_t from, int32_t to, int64_t value) {
+    ARRAY_FILL_CHECK(ref, from, to);
+    uint64_t *data = ARRAY_DATA_PTR(ref, uint64_t);
+    uint32_t i;
+    for (i = (uint32_t)from; i < (uint32_t)to; i++) {
+        data[i] = (uint64_t)value;
+    }
+}
+
+// content equality for arrays of integral components, where Java's
+// per-element semantics coincide with byte equality (the compiler
+// does not lower float/double comparisons here: their NaN handling
+// differs from a bitwise compare)
+int32_t _Jrt_array_equals(ref_t a, ref_t b) {
+    if (a.object == b.object) {
+        return 1;
+    }
+    if (a.object == NULL || b.object == NULL) {
+        return 0;
+    }
+    struct array_base *a_base = ARRAY_BASE_PTR(a);
+    struct array_base *b_base = ARRAY_BASE_PTR(b);
+    if (a_base->length != b_base->length || a_base->width != b_base->width) {
+        return 0;
+    }
+    return memcmp(ARRAY_DATA_PTR(a, uint8_t), ARRAY_DATA_PTR(b, uint8_t),
+                  (size_t)a_base->length * a_base->width) == 0;
+}
+
+// 31^1 .. 31^8 (mod 2^32), highest power first
+static const uint32_t HASH_POW31[8] = {
+    1742810335u, 887503681u, 28629151u, 923521u, 29791u, 961u, 31u, 1u,
+};
+#define HASH_POW31_8 2487512833u
+
+// Java's h = 31*h + e recurrence is serial, but splitting it into
+// h*31^8 + sum(e[i+j] * 31^(7-j)) makes the per-element multiplies
+// independent, so the inner loop vectorizes
+JRT_BULKOP static int32_t array_hash_4(const int32_t *data, uint32_t count) {
+    uint32_t hash = 1;
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t chunk = 0;
+        uint32_t j;
+        for (j = 0; j < 8; j++) {
+            chunk += (uint32_t)data[i + j] * HASH_POW31[j];
+        }
+        hash = hash * HASH_POW31_8 + chunk;
+    }
+    for (; i < count; i++) {
+        hash = hash * 31 + (uint32_t)data[i];
+    }
+    return (int32_t)hash;
+}
+
+JRT_BULKOP static int32_t array_hash_8(const int64_t *data, uint32_t count) {
+    uint32_t hash = 1;
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t chunk = 0;
+        uint32_t j;
+        for (j = 0; j < 8; j++) {
+            uint64_t value = (uint64_t)data[i + j];
+            chunk += (uint32_t)(value ^ (value >> 32)) * HASH_POW31[j];
+        }
+        hash = hash * HASH_POW31_8 + chunk;
+    }
+    for (; i < count; i++) {
+        uint64_t value = (uint64_t)data[i];
+        hash = hash * 31 + (uint32_t)(value ^ (value >> 32));
+    }
+    return (int32_t)hash;
+}
+
+// Arrays.hashCode over signed integral components; the compiler only
+// lowers byte[], short[], int[] and long[] call sites here (char[]
+// and boolean[] hash their elements differently, and the width alone
+// cannot distinguish them)
+int32_t _Jrt_array_hash(ref_t ref) {
+    // Arrays.hashCode(null) is defined as 0
+    if (ref.object == NULL) {
+        return 0;
+    }
+    struct array_base *base = ARRAY_BASE_PTR(ref);
+    uint32_t count = base->length;
+    uint32_t hash = 1;
+    uint32_t i;
+    switch (base->width) {
+    case 1: {
+        const int8_t *data = ARRAY_DATA_PTR(ref, int8_t);
+        for (i = 0; i < count; i++) {
+            hash = hash * 31 + (uint32_t)(int32_t)data[i];
+        }
+        return (int32_t)hash;
+    }
+    case 2: {
+        const int16_t *data = ARRAY_DATA_PTR(ref, int16_t);
+        for (i = 0; i < count; i++) {
+            hash = hash * 31 + (uint32_t)(int32_t)data[i];
+        }
+        return (int32_t)hash;
+    }
+    case 4:
+        return array_hash_4(ARRAY_DATA_PTR(ref, int32_t), count);
+    case 8:
+        return array_hash_8(ARRAY_DATA_PTR(ref, int64_t), count);
+    default:
+        PANIC("Array hash over unexpected component width %u. Aborting.",
+              base->width);
+    }
+}
@@ -0,0 +1,282 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <setjmp.h>
+
+#include "../lib/alloc.h"
+#include "../lib/gc.h"
+#include "../lib/object.h"
+#include "../lib/lock.h"
+#include "../lib/monitor.h"
+#include "../lib/thread.h"
+#include "../lib/utils.h"
+
+// Conservative, non-moving mark-sweep over the chunked heap:
+//
+//  - roots are the calling thread's stack, its registers (spilled into
+//    a jmp_buf) and the data segment, where static fields live as
+//    compiler-emitted globals
+//  - marking scans every word of a live block's payload, so interior
+//    pointers (e.g. cached array element pointers) keep objects alive
+//  - sweeping coalesces dead blocks, recycles fully-empty chunks
+//    through the allocator's free list, and frees large allocations;
+//    free space inside partially-live chunks is not yet reused
+//
+// Collection currently assumes a single mutator thread: only the
+// calling thread's stack is scanned. Stopping and scanning other
+// threads needs safepoint support in the thread layer.
+
+#define GC_PRESSURE_THRESHOLD (64 * 1024 * 1024)
+
+static void *gc_stack_base = NULL;
+
+static _Atomic size_t gc_pressure = 0;
+
+// the main thread counts as the first mutator
+static _Atomic uint32_t gc_mutators = 1;
+
+// sorted index of live block payloads, rebuilt each cycle
+struct gc_index_entry {
+    uint8_t *start;
+    struct alloc_block *block;
+};
+
+static struct gc_index_entry *gc_index = NULL;
+static size_t gc_index_len = 0;
+static size_t gc_index_cap = 0;
+
+static struct alloc_block **gc_mark_stack = NULL;
+static size_t gc_mark_stack_len = 0;
+static size_t gc_mark_stack_cap = 0;
+
+static void gc_index_push(struct alloc_block *block) {
+    if (gc_index_len == gc_index_cap) {
+        gc_index_cap = gc_index_cap ? gc_index_cap * 2 : 1024;
+        gc_index = realloc(gc_index, gc_index_cap * sizeof(struct gc_index_entry));
+        if (gc_index == NULL) {
+            PANIC("Failed to grow collector block index. Aborting.");
+        }
+    }
+    gc_index[gc_index_len].start = ALLOC_BLOCK_PAYLOAD(block);
+    gc_index[gc_index_len].block = block;
+    gc_index_len++;
+}
+
+static int gc_index_cmp(const void *a, const void *b) {
+    uint8_t *sa = ((const struct gc_index_entry *)a)->start;
+    uint8_t *sb = ((const struct gc_index_entry *)b)->start;
+    if (sa < sb) {
+        return -1;
+    }
+    if (sa > sb) {
+        return 1;
+    }
+    return 0;
+}
+
+static void gc_index_build(void) {
+    gc_index_len = 0;
+
+    struct alloc_chunk *chunk;
+    for (chunk = alloc_chunks; chunk != NULL; chunk = chunk->next) {
+        uint8_t *cursor = ALLOC_CHUNK_BLOCKS(chunk);
+        while (cursor < chunk->limit) {
+            struct alloc_block *block = (struct alloc_block *)cursor;
+            if (!(block->flags & ALLOC_BLOCK_FREE)) {
+                gc_index_push(block);
+            }
+            cursor += block->size;
+        }
+    }
+
+    struct alloc_large *large;
+    for (large = alloc_larges; large != NULL; large = large->next) {
+        gc_index_push(&large->block);
+    }
+
+    qsort(gc_index, gc_index_len, sizeof(struct gc_index_entry), gc_index_cmp);
+}
+
+// finds the block containing `ptr` (interior pointers included)
+static struct alloc_block *gc_index_find(uint8_t *ptr) {
+    size_t lo = 0;
+    size_t hi = gc_index_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (gc_index[mid].start <= ptr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return NULL;
+    }
+    struct alloc_block *block = gc_index[lo - 1].block;
+    if (ptr < (uint8_t *)block + block->size) {
+        return block;
+    }
+    return NULL;
+}
+
+static void gc_mark(void *ptr) {
+    struct alloc_block *block = gc_index_find(ptr);
+    if (block == NULL || (block->flags & ALLOC_BLOCK_MARK)) {
+        return;
+    }
+    block->flags |= ALLOC_BLOCK_MARK;
+    if (gc_mark_stack_len == gc_mark_stack_cap) {
+        gc_mark_stack_cap = gc_mark_stack_cap ? gc_mark_stack_cap * 2 : 1024;
+        gc_mark_stack =
+            realloc(gc_mark_stack, gc_mark_stack_cap * sizeof(struct alloc_block *));
+        if (gc_mark_stack == NULL) {
+            PANIC("Failed to grow collector mark stack. Aborting.");
+        }
+    }
+    gc_mark_stack[gc_mark_stack_len++] = block;
+}
+
+static void gc_scan_range(void *from, void *to) {
+    uintptr_t cursor = ((uintptr_t)from + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    while (cursor + sizeof(void *) <= (uintptr_t)to) {
+        gc_mark(*(void **)cursor);
+        cursor += sizeof(void *);
+    }
+}
+
+static void gc_mark_from_roots(void) {
+    // registers first: setjmp spills the callee-saved set
+    jmp_buf registers;
+    setjmp(registers);
+    gc_scan_range(&registers, (uint8_t *)&registers + sizeof(registers));
+
+    // the stack between this frame and the base recorded in gc_init
+    gc_scan_range(&registers, gc_stack_base);
+
+    // Thread objects of running threads are reachable through the
+    // registry even when no stack references them anymore
+    thread_registry_lock();
+    {
+        struct thread *thread;
+        for (thread = thread_registry; thread != NULL; thread = thread->next) {
+            gc_mark(thread->object.object);
+        }
+    }
+    thread_registry_unlock();
+
+#ifdef __GLIBC__
+    // static reference fields are globals in the data segment
+    {
+        extern char __data_start[], _end[];
+        gc_scan_range(__data_start, _end);
+    }
+#endif
+
+    while (gc_mark_stack_len > 0) {
+        struct alloc_block *block = gc_mark_stack[--gc_mark_stack_len];
+        gc_scan_range(ALLOC_BLOCK_PAYLOAD(block), (uint8_t *)block + block->size);
+    }
+}
+
+// every payload starts with an object header; dead objects with an
+// inflated lock give their monitor back
+static void gc_finalize_block(struct alloc_block *block) {
+    struct object_base *base = (struct object_base *)ALLOC_BLOCK_PAYLOAD(block);
+    monitor_t *monitor = lock_monitor_peek(&base->lock);
+    if (monitor != NULL) {
+        monitor_destroy(monitor);
+        free(monitor);
+    }
+}
+
+static void gc_sweep(void) {
+    struct alloc_large **large_link = &alloc_larges;
+    while (*large_link != NULL) {
+        struct alloc_large *large = *large_link;
+        if (large->block.flags & ALLOC_BLOCK_MARK) {
+            large->block.flags &= ~ALLOC_BLOCK_MARK;
+            large_link = &large->next;
+        } else {
+            *large_link = large->next;
+            gc_finalize_block(&large->block);
+            free(large);
+        }
+    }
+
+    struct alloc_chunk **chunk_link = &alloc_chunks;
+    while (*chunk_link != NULL) {
+        struct alloc_chunk *chunk = *chunk_link;
+        struct alloc_block *free_run = NULL;
+        int live = 0;
+        uint8_t *cursor = ALLOC_CHUNK_BLOCKS(chunk);
+        while (cursor < chunk->limit) {
+            struct alloc_block *block = (struct alloc_block *)cursor;
+            cursor += block->size;
+            if (block->flags & ALLOC_BLOCK_MARK) {
+                block->flags &= ~ALLOC_BLOCK_MARK;
+                free_run = NULL;
+                live = 1;
+            } else {
+                if (!(block->flags & ALLOC_BLOCK_FREE)) {
+                    gc_finalize_block(block);
+                }
+                if (free_run != NULL) {
+                    // coalesce with the preceding dead block
+                    free_run->size += block->size;
+                } else {
+                    block->flags = ALLOC_BLOCK_FREE;
+                    free_run = block;
+                }
+            }
+        }
+        if (live) {
+            chunk_link = &chunk->next;
+        } else {
+            *chunk_link = chunk->next;
+            alloc_chunk_release(chunk);
+        }
+    }
+}
+
+void gc_init(void *stack_base) {
+    gc_stack_base = stack_base;
+}
+
+void gc_mutator_attach(void) {
+    atomic_fetch_add_explicit(&gc_mutators, 1, memory_order_relaxed);
+}
+
+void gc_mutator_detach(void) {
+    atomic_fetch_sub_explicit(&gc_mutators, 1, memory_order_relaxed);
+}
+
+uint32_t gc_mutator_count(void) {
+    return atomic_load_explicit(&gc_mutators, memory_order_relaxed);
+}
+
+void gc_maybe_collect(size_t pending_bytes) {
+    size_t pressure =
+        atomic_fetch_add_explicit(&gc_pressure, pending_bytes, memory_order_relaxed);
+    if (pressure + pending_bytes >= GC_PRESSURE_THRESHOLD) {
+        gc_collect();
+    }
+}
+
+void gc_collect(void) {
+    if (gc_stack_base == NULL) {
+        return;
+    }
+    // with concurrent mutators the heap keeps growing instead: their
+    // stacks can't be scanned until safepoints can stop them
+    if (atomic_load_explicit(&gc_mutators, memory_order_relaxed) > 1) {
+        return;
+    }
+    alloc_lock();
+    atomic_store_explicit(&gc_pressure, 0, memory_order_relaxed);
+    alloc_tlab_retire();
+    gc_index_build();
+    gc_mark_from_roots();
+    gc_sweep();
+    alloc_unlock();
+}
@@ -0,0 +1,91 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdlib.h>
+#include <sched.h>
+
+#include "../lib/lock.h"
+#include "../lib/monitor.h"
+#include "../lib/thread.h"
+
+void lock_enter_slow(lockword_t *word) {
+    uint32_t tid = thread_id_self();
+    monitor_t *mon = NULL;
+
+    for (;;) {
+        uintptr_t current = atomic_load_explicit(word, memory_order_relaxed);
+
+        if (current & LOCK_INFLATED) {
+            monitor_t *inflated = LOCK_MONITOR(current);
+            // another thread inflated first: discard our own monitor
+            if (mon != NULL) {
+                monitor_exit(mon);
+                monitor_destroy(mon);
+                free(mon);
+            }
+            monitor_enter(inflated);
+            return;
+        }
+
+        if (current != 0 && LOCK_TID(current) == tid) {
+            // recursive enter; inflate when the count saturates
+            if (LOCK_COUNT(current) == LOCK_COUNT_MAX) {
+                monitor_enter(lock_inflate(word));
+            } else {
+                atomic_store_explicit(word,
+                                      current + ((uintptr_t)1 << LOCK_COUNT_SHIFT),
+                                      memory_order_relaxed);
+            }
+            return;
+        }
+
+        if (current == 0) {
+            // the lock was released while we were waiting: if contention
+            // forced us to create a monitor we already own, install it,
+            // otherwise take the lock thinly
+            uintptr_t expected = 0;
+            uintptr_t desired;
+            if (mon != NULL) {
+                desired = (uintptr_t)mon | LOCK_INFLATED;
+            } else {
+                desired = LOCK_THIN(tid, 1);
+            }
+            if (atomic_compare_exchange_weak_explicit(
+                    word, &expected, desired,
+                    memory_order_acquire, memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+
+        // held thinly by another thread: acquire a fresh monitor up
+        // front and wait for the holder to release the thin lock
+        if (mon == NULL) {
+            mon = malloc(sizeof(monitor_t));
+            monitor_init(mon);
+            monitor_enter(mon);
+        }
+        sched_yield();
+    }
+}
+
+monitor_t *lock_inflate(lockword_t *word) {
+    uintptr_t current = atomic_load_explicit(word, memory_order_acquire);
+    if (current & LOCK_INFLATED) {
+        return LOCK_MONITOR(current);
+    }
+
+    // TODO: ensure calling thread owns the lock
+    monitor_t *mon = malloc(sizeof(monitor_t));
+    monitor_init(mon);
+
+    // carry the thin recursion count over into the recursive mutex
+    uintptr_t count = LOCK_COUNT(current);
+    uintptr_t i;
+    for (i = 0; i < count; i++) {
+        monitor_enter(mon);
+    }
+
+    atomic_store_explicit(word, (uintptr_t)mon | LOCK_INFLATED,
+                          memory_order_release);
+    return mon;
+}
@@ -0,0 +1,82 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../lib/lockprof.h"
+#include "../lib/thread.h"
+#include "../lib/utils.h"
+
+#ifdef JRT_MONITOR_PROFILE
+
+#ifndef CLOCK_MONOTONIC_COARSE
+#define CLOCK_MONOTONIC_COARSE CLOCK_MONOTONIC
+#endif
+
+static struct lockprof_event lockprof_ring[LOCKPROF_RING_SIZE];
+static _Atomic uint64_t lockprof_events = 0;
+
+uint64_t lockprof_now_nsec(void) {
+    struct timespec ts;
+    ensure(clock_gettime(CLOCK_MONOTONIC_COARSE, &ts));
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+void lockprof_sample(void *monitor, uint64_t blocked_nsec, uint64_t total_entries,
+                     uint64_t total_blocked_nsec) {
+    uint64_t event =
+        atomic_fetch_add_explicit(&lockprof_events, 1, memory_order_relaxed);
+    if (event % LOCKPROF_SAMPLE_INTERVAL != 0) {
+        return;
+    }
+    struct lockprof_event *slot =
+        &lockprof_ring[(event / LOCKPROF_SAMPLE_INTERVAL) % LOCKPROF_RING_SIZE];
+    slot->monitor = monitor;
+    slot->thread_id = thread_id_self();
+    slot->blocked_nsec = blocked_nsec;
+    slot->total_entries = total_entries;
+    slot->total_blocked_nsec = total_blocked_nsec;
+}
+
+// best-effort diagnostics from a signal handler: raw write to stderr,
+// tolerating events that are concurrently overwritten
+static void lockprof_dump(int signum) {
+    (void)signum;
+    char line[160];
+    int len = snprintf(line, sizeof(line),
+                       "-- monitor contention ring (%llu events total) --\n",
+                       (unsigned long long)atomic_load_explicit(
+                           &lockprof_events, memory_order_relaxed));
+    if (write(STDERR_FILENO, line, len) < 0) {
+        return;
+    }
+    int i;
+    for (i = 0; i < LOCKPROF_RING_SIZE; i++) {
+        struct lockprof_event *slot = &lockprof_ring[i];
+        if (slot->monitor == NULL) {
+            continue;
+        }
+        len = snprintf(line, sizeof(line),
+                       "monitor %p thread %u blocked %llu ns (monitor total: %llu "
+                       "entries, %llu ns)\n",
+                       slot->monitor, slot->thread_id,
+                       (unsigned long long)slot->blocked_nsec,
+                       (unsigned long long)slot->total_entries,
+                       (unsigned long long)slot->total_blocked_nsec);
+        if (write(STDERR_FILENO, line, len) < 0) {
+            return;
+        }
+    }
+}
+
+void lockprof_init(void) {
+    struct sigaction action = {0};
+    action.sa_handler = lockprof_dump;
+    action.sa_flags = SA_RESTART;
+    ensure(sigaction(SIGUSR1, &action, NULL));
+}
+
+#endif // JRT_MONITOR_PROFILE
@@ -0,0 +1,122 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "../lib/metadata.h"
+#include "../lib/utils.h"
+
+// section bounds, provided by the linker when the compiler emitted a
+// "jrt_metadata" section; weak so the runtime also links into
+// programs without one
+extern char __start_jrt_metadata[] __attribute__((weak));
+extern char __stop_jrt_metadata[] __attribute__((weak));
+
+#define METADATA_IMAGE_MAGIC 0x3174654d74724aull // "JrtMet1"
+#define METADATA_PAGE_SIZE 4096
+
+// exactly one page, so the shared bytes that follow it sit at a
+// page-aligned file offset as mmap requires
+struct metadata_image_header {
+    uint64_t magic;
+    uint64_t size;     // of the shared bytes
+    uint64_t base;     // address the publisher held them at (diagnostic)
+    uint64_t checksum; // FNV-1a of the bytes
+    char pad[METADATA_PAGE_SIZE - 4 * sizeof(uint64_t)];
+};
+
+// FNV-1a; the embedded vtable pointers make this double as an ASLR
+// and build-identity check
+static uint64_t metadata_checksum(const uint8_t *data, size_t size) {
+    uint64_t hash = 1469598103934665603ull;
+    size_t i;
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static int metadata_try_map(int fd, uintptr_t begin, size_t size,
+                            uint64_t checksum) {
+    struct metadata_image_header header;
+    if (pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+        return 0;
+    }
+    if (header.magic != METADATA_IMAGE_MAGIC || header.size != size ||
+        header.checksum != checksum) {
+        return 0;
+    }
+    // contents verified identical: replacing the private pages with a
+    // shared file-backed mapping is invisible to readers
+    void *mapped = mmap((void *)begin, size, PROT_READ,
+                        MAP_SHARED | MAP_FIXED, fd, sizeof(header));
+    return mapped != MAP_FAILED;
+}
+
+static void metadata_publish(const char *path, uintptr_t begin, size_t size,
+                             uint64_t checksum) {
+    // write-then-rename, so concurrently starting workers only ever
+    // see a complete image under the published name
+    char tmp_path[4096];
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path,
+                           (int)getpid());
+    if (written < 0 || (size_t)written >= sizeof(tmp_path)) {
+        return;
+    }
+    int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return;
+    }
+    struct metadata_image_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = METADATA_IMAGE_MAGIC;
+    header.size = size;
+    header.base = begin;
+    header.checksum = checksum;
+    if (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+        write(fd, (const void *)begin, size) == (ssize_t)size &&
+        rename(tmp_path, path) == 0) {
+        // the publisher shares its own pages too
+        metadata_try_map(fd, begin, size, checksum);
+    } else {
+        unlink(tmp_path);
+    }
+    close(fd);
+}
+
+void metadata_init(void) {
+    const char *path = getenv("JRT_METADATA_IMAGE");
+    if (path == NULL) {
+        return;
+    }
+    uintptr_t start = (uintptr_t)__start_jrt_metadata;
+    uintptr_t stop = (uintptr_t)__stop_jrt_metadata;
+    if (start == 0 || stop == 0) {
+        return; // no metadata section in this program
+    }
+    // only whole pages can be remapped; the sliver outside them stays
+    // private, which costs at most two pages per process
+    uintptr_t begin = (start + METADATA_PAGE_SIZE - 1) &
+                      ~((uintptr_t)METADATA_PAGE_SIZE - 1);
+    uintptr_t end = stop & ~((uintptr_t)METADATA_PAGE_SIZE - 1);
+    if (begin >= end) {
+        return;
+    }
+    size_t size = end - begin;
+    uint64_t checksum = metadata_checksum((const uint8_t *)begin, size);
+
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        int mapped = metadata_try_map(fd, begin, size, checksum);
+        close(fd);
+        if (mapped) {
+            return;
+        }
+        // stale image (different build or base): republish below
+    }
+    metadata_publish(path, begin, size, checksum);
+}
@@ -4,19 +4,25 @@
 
 #include "../lib/ref.h"
 #include "../lib/object.h"
+#include "../lib/class.h"
 #include "../lib/array.h"
 #include "../lib/monitor.h"
+#include "../lib/lock.h"
 #include "../lib/utils.h"
 
 void _ZN4java4lang6Object15registerNativesIu9Jed9fc4b9EEvv() {}
 
-ref_t _ZN4java4lang6Object8getClassIu9Jd57352f6EEN4java4lang5ClassEv(ref_t _this) {
-    trap_unimplemented("java.lang.Object.getClass");
-    return REF_NULL;
+ref_t _ZN4java4lang6Object8getClassIu9Jd57352f6EEN4java4lang5ClassEv(ref_t this) {
+    struct ref_class_metadata *metadata = REF_VTABLE_PTR(this)->metadata;
+    // runtime-stubbed vtables carry no metadata record
+    if (metadata == NULL) {
+        trap_unimplemented("java.lang.Object.getClass");
+    }
+    return class_for_metadata(metadata);
 }
 
 uint32_t _ZN4java4lang6Object8hashCodeIu9J7c7c3589EEiv(ref_t this) {
-    return REF_HASH(this);
+    return object_identity_hash(OBJECT_BASE_PTR(this));
 }
 
 ref_t _ZN4java4lang6Object5cloneIu9J117cf78dEEN4java4lang6ObjectEv(ref_t _this) {
@@ -25,35 +31,94 @@ ref_t _ZN4java4lang6Object5cloneIu9J117cf78dEEN4java4lang6ObjectEv(ref_t _this)
 }
 
 void _ZN4java4lang6Object6notifyIu9Jec9f6595EEvv(ref_t this) {
-    monitor_t *monitor = &OBJECT_BASE_PTR(this)->monitor;
+    monitor_t *monitor = lock_monitor_peek(&OBJECT_BASE_PTR(this)->lock);
     // TODO: ensure calling thread owns the monitor
-    monitor_notify_one(monitor);
+    // without an inflated monitor there can be no waiters
+    if (monitor != NULL) {
+        monitor_notify_one(monitor);
+    }
 }
 
 void _ZN4java4lang6Object9notifyAllIu9J01f1085cEEvv(ref_t this) {
-    monitor_t *monitor = &OBJECT_BASE_PTR(this)->monitor;
+    monitor_t *monitor = lock_monitor_peek(&OBJECT_BASE_PTR(this)->lock);
     // TODO: ensure calling thread owns the monitor
-    monitor_notify_all(monitor);
+    // without an inflated monitor there can be no waiters
+    if (monitor != NULL) {
+        monitor_notify_all(monitor);
+    }
 }
 
 void _ZN4java4lang6Object4waitIu9J70446489EEvl(ref_t this, uint64_t timeout) {
-    monitor_t *monitor = &OBJECT_BASE_PTR(this)->monitor;
+    monitor_t *monitor = lock_inflate(&OBJECT_BASE_PTR(this)->lock);
     // TODO: ensure calling thread owns the monitor
     monitor_wait(monitor, timeout);
 }
 
+// copies below this go through the width-specialized loops, which
+// the compiler turns into straight-line SIMD code; only large or
+// potentially-overlapping copies pay for memmove dispatch
+#define ARRAYCOPY_MEMMOVE_THRESHOLD 256
+
+static void arraycopy_out_of_bounds(int32_t src_pos, int32_t dest_pos, int32_t length) {
+    // TODO: throw java.lang.ArrayIndexOutOfBoundsException
+    PANIC("Array copy out of bounds (src_pos %d, dest_pos %d, length %d). Aborting.",
+          src_pos, dest_pos, length);
+}
+
 void _ZN4java4lang6System9arraycopyIu9Jb7e57d76EEvN4java4lang6ObjectEiN4java4lang6ObjectEii(ref_t src, int32_t src_pos, ref_t dest, int32_t dest_pos, int32_t length) {
-    size_t width = ARRAY_BASE_PTR(src)->width;
+    struct array_base *src_base = ARRAY_BASE_PTR(src);
+    struct array_base *dest_base = ARRAY_BASE_PTR(dest);
+    size_t width = src_base->width;
     // TODO: properly ensure array types match
-    if (width != ARRAY_BASE_PTR(dest)->width) {
+    if (width != dest_base->width) {
         PANIC("Attempt to copy between arrays of different element widths.");
     }
-    // TODO: perform bounds checks
-    off_t src_off = width * src_pos;
-    off_t dest_off = width * dest_pos;
-    size_t length_in_bytes = width * length;
-    void *src_ptr = &ARRAY_DATA_PTR(src, uint8_t)[src_off];
-    void *dest_ptr = &ARRAY_DATA_PTR(dest, uint8_t)[dest_off];
+
+    // negative arguments wrap to huge unsigned values, so a single
+    // comparison per array covers position, length and overflow; the
+    // checks combine branchlessly into one test with a cold out-of-line
+    // failure path
+    uint64_t src_end = (uint64_t)(uint32_t)src_pos + (uint32_t)length;
+    uint64_t dest_end = (uint64_t)(uint32_t)dest_pos + (uint32_t)length;
+    if ((src_end > src_base->length) | (dest_end > dest_base->length)) {
+        arraycopy_out_of_bounds(src_pos, dest_pos, length);
+    }
+
+    const uint8_t *src_ptr = &ARRAY_DATA_PTR(src, uint8_t)[width * (uint32_t)src_pos];
+    uint8_t *dest_ptr = &ARRAY_DATA_PTR(dest, uint8_t)[width * (uint32_t)dest_pos];
+    size_t length_in_bytes = width * (uint32_t)length;
+
+    if (length_in_bytes < ARRAYCOPY_MEMMOVE_THRESHOLD && src.object != dest.object) {
+        // distinct arrays can't overlap, so copy forward element-wise
+        uint32_t count = (uint32_t)length;
+        uint32_t i;
+        switch (width) {
+        case 1:
+            for (i = 0; i < count; i++) {
+                dest_ptr[i] = src_ptr[i];
+            }
+            return;
+        case 2:
+            for (i = 0; i < count; i++) {
+                ((uint16_t *)dest_ptr)[i] = ((const uint16_t *)src_ptr)[i];
+            }
+            return;
+        case 4:
+            for (i = 0; i < count; i++) {
+                ((uint32_t *)dest_ptr)[i] = ((const uint32_t *)src_ptr)[i];
+            }
+            return;
+        case 8:
+            for (i = 0; i < count; i++) {
+                ((uint64_t *)dest_ptr)[i] = ((const uint64_t *)src_ptr)[i];
+            }
+            return;
+        default:
+            memcpy(dest_ptr, src_ptr, length_in_bytes);
+            return;
+        }
+    }
+
     memmove(dest_ptr, src_ptr, length_in_bytes);
 }
 
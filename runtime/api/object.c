@@ -1,30 +1,104 @@
 #define _GNU_SOURCE 1
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <memory.h>
 
 #include "../lib/ref.h"
 #include "../lib/object.h"
-#include "../lib/monitor.h"
+#include "../lib/lock.h"
+#include "../lib/profile.h"
 
 ref_t _Jrt_object_new(uint64_t size, void *vtable) {
+    PROFILE_ALLOC(PROFILE_OBJECT_NEW, sizeof(struct object_base) + size);
     return object_new(size, vtable);
 }
 
+// Initializes a caller-provided frame slot as an object; the backend
+// uses this for allocations its escape analysis proves never outlive
+// the frame. The collector's conservative stack scan sees the slot
+// like any other stack word, so no heap bookkeeping is involved.
+#ifdef JRT_COMPRESSED_REFS
+// the compressed-refs header carries the vtable word and is 24 bytes,
+// which overflows the backend's 16-byte frame slot reservation; divert
+// to the heap until the backend sizes slots per configuration
+ref_t _Jrt_object_init_onstack(void *slot, uint64_t data_size, void *vtable) {
+    (void)slot;
+    return object_new(data_size, vtable);
+}
+#else
+// the backend reserves 16 bytes of header room in front of the
+// fields when it sets up a frame slot for a stack-allocated object
+_Static_assert(sizeof(struct object_base) <= 16,
+               "object header exceeds the backend's frame slot reservation");
+
+ref_t _Jrt_object_init_onstack(void *slot, uint64_t data_size, void *vtable) {
+    memset(slot, 0, sizeof(struct object_base) + data_size);
+    ref_t ref = {
+        .object = slot,
+        .vtable = vtable,
+    };
+    lock_init(&OBJECT_BASE_PTR(ref)->lock);
+    return ref;
+}
+#endif
+
 void *_Jrt_object_field_ptr(ref_t ref) {
     return OBJECT_DATA_PTR(ref, void);
 }
 
 void *_Jrt_object_vtable_lookup(ref_t ref, uint64_t index) {
+    PROFILE_COUNT(PROFILE_VTABLE_LOOKUP);
     return REF_VTABLE_PTR(ref)->methods[index];
 }
 
+// Interface dispatch cache: itables are immutable, so the mapping
+// (vtable, interface) -> method offset can be memoized. Entries are
+// write-once: a writer claims a slot by CASing the vtable word to a
+// sentinel, fills in the other fields, and publishes with a release
+// store; colliding pairs simply keep taking the scan slow path.
+
+#define ITABLE_CACHE_SIZE 1024
+#define ITABLE_CACHE_CLAIMED ((uintptr_t)1)
+
+struct itable_cache_entry {
+    _Atomic uintptr_t vtable;
+    uintptr_t iface;
+    uint32_t offset;
+};
+
+static struct itable_cache_entry itable_cache[ITABLE_CACHE_SIZE];
+
+static inline struct itable_cache_entry *itable_cache_slot(void *vtable, void *iface) {
+    uintptr_t hash = ((uintptr_t)vtable ^ ((uintptr_t)iface >> 3)) * 0x9e3779b97f4a7c15ull;
+    return &itable_cache[(hash >> 32) & (ITABLE_CACHE_SIZE - 1)];
+}
+
 void *_Jrt_object_itable_lookup(ref_t ref, void *iface, uint64_t index) {
+    PROFILE_COUNT(PROFILE_ITABLE_LOOKUP);
+    struct ref_vtable_base *vtable = REF_VTABLE_PTR(ref);
+    struct itable_cache_entry *entry = itable_cache_slot(vtable, iface);
+    uintptr_t cached = atomic_load_explicit(&entry->vtable, memory_order_acquire);
+    if (cached == (uintptr_t)vtable && entry->iface == (uintptr_t)iface) {
+        return REF_VTABLE_PTR(ref)->methods[entry->offset + index];
+    }
+
     struct ref_itable_base *table = REF_ITABLE_PTR(ref);
     uint32_t i;
     for (i = 0; i < table->length; i++) {
         if (table->entries[i].interface == iface) {
             uint32_t offset = table->entries[i].offset;
+            if (cached == 0) {
+                uintptr_t expected = 0;
+                if (atomic_compare_exchange_strong_explicit(
+                        &entry->vtable, &expected, ITABLE_CACHE_CLAIMED,
+                        memory_order_relaxed, memory_order_relaxed)) {
+                    entry->iface = (uintptr_t)iface;
+                    entry->offset = offset;
+                    atomic_store_explicit(&entry->vtable, (uintptr_t)vtable,
+                                          memory_order_release);
+                }
+            }
             return REF_VTABLE_PTR(ref)->methods[offset + index];
         }
     }
@@ -32,12 +106,10 @@ void *_Jrt_object_itable_lookup(ref_t ref, void *iface, uint64_t index) {
 }
 
 void _Jrt_object_monitorenter(ref_t ref) {
-    monitor_t *monitor = &OBJECT_BASE_PTR(ref)->monitor;
-    monitor_enter(monitor);
+    lock_enter(&OBJECT_BASE_PTR(ref)->lock);
 }
 
 void _Jrt_object_monitorexit(ref_t ref) {
-    monitor_t *monitor = &OBJECT_BASE_PTR(ref)->monitor;
     // TODO: ensure calling thread owns the monitor
-    monitor_exit(monitor);
+    lock_exit(&OBJECT_BASE_PTR(ref)->lock);
 }
@@ -0,0 +1,121 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+
+#include "../lib/park.h"
+#include "../lib/utils.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#else
+#include <sched.h>
+#endif
+
+#define PARK_SPIN_COUNT 64
+
+static inline int park_try_consume(park_t *park) {
+    return atomic_exchange_explicit(&park->state, 0, memory_order_acquire) == 1;
+}
+
+#ifdef __linux__
+
+// FUTEX_WAIT interprets relative timeouts against CLOCK_MONOTONIC
+static int park_futex_wait(park_t *park, const struct timespec *rel) {
+    return (int)syscall(SYS_futex, &park->state, FUTEX_WAIT_PRIVATE, 0, rel, NULL, 0);
+}
+
+static void park_futex_wake(park_t *park) {
+    syscall(SYS_futex, &park->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+void park_wait(park_t *park, uint64_t timeout_msec) {
+    int i;
+    for (i = 0; i < PARK_SPIN_COUNT; i++) {
+        if (park_try_consume(park)) {
+            return;
+        }
+    }
+
+    struct timespec deadline;
+    if (timeout_msec > 0) {
+        ensure(clock_gettime(CLOCK_MONOTONIC, &deadline));
+        timespec_add_msec(&deadline, timeout_msec);
+    }
+
+    for (;;) {
+        if (park_try_consume(park)) {
+            return;
+        }
+        struct timespec rel;
+        struct timespec *relptr = NULL;
+        if (timeout_msec > 0) {
+            struct timespec now;
+            ensure(clock_gettime(CLOCK_MONOTONIC, &now));
+            rel.tv_sec = deadline.tv_sec - now.tv_sec;
+            rel.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (rel.tv_nsec < 0) {
+                rel.tv_sec -= 1;
+                rel.tv_nsec += 1000000000;
+            }
+            if (rel.tv_sec < 0) {
+                return;
+            }
+            relptr = &rel;
+        }
+        if (park_futex_wait(park, relptr) != 0 && errno == ETIMEDOUT) {
+            return;
+        }
+    }
+}
+
+void park_wake(park_t *park) {
+    if (atomic_exchange_explicit(&park->state, 1, memory_order_release) == 0) {
+        park_futex_wake(park);
+    }
+}
+
+#else // !__linux__
+
+// portable fallback: spin with yields; platforms without futexes can
+// grow a condvar-based path if this ever matters there
+void park_wait(park_t *park, uint64_t timeout_msec) {
+    struct timespec deadline;
+    if (timeout_msec > 0) {
+        timespec_now(&deadline);
+        timespec_add_msec(&deadline, timeout_msec);
+    }
+    for (;;) {
+        if (park_try_consume(park)) {
+            return;
+        }
+        if (timeout_msec > 0) {
+            struct timespec now;
+            timespec_now(&now);
+            if (now.tv_sec > deadline.tv_sec ||
+                (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+                return;
+            }
+        }
+        sched_yield();
+    }
+}
+
+void park_wake(park_t *park) {
+    atomic_store_explicit(&park->state, 1, memory_order_release);
+}
+
+#endif
+
+void _Jrt_thread_sleep(uint64_t msec) {
+    // park_wait reads a zero timeout as "no deadline", which would
+    // block forever on a word nobody wakes; sleep(0) just yields
+    if (msec == 0) {
+        return;
+    }
+    // a private park word that is never woken: sleeps out the timeout
+    park_t park = PARK_INITIALIZER;
+    park_wait(&park, msec);
+}
@@ -0,0 +1,149 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <execinfo.h>
+
+#include "../lib/profile.h"
+#include "../lib/utils.h"
+
+#ifdef JRT_PROFILE
+
+static const char *profile_entry_point_names[PROFILE_ENTRY_POINTS] = {
+    [PROFILE_OBJECT_NEW] = "_Jrt_object_new",
+    [PROFILE_ARRAY_NEW] = "_Jrt_array_new",
+    [PROFILE_LDSTR] = "_Jrt_ldstr",
+    [PROFILE_THROW] = "_Jrt_throw",
+    [PROFILE_VTABLE_LOOKUP] = "_Jrt_object_vtable_lookup",
+    [PROFILE_ITABLE_LOOKUP] = "_Jrt_object_itable_lookup",
+};
+
+struct profile_counters {
+    uint64_t calls[PROFILE_ENTRY_POINTS];
+    uint64_t bytes[PROFILE_ENTRY_POINTS];
+    uint64_t sizes[PROFILE_ENTRY_POINTS][PROFILE_SIZE_BUCKETS];
+    // bytes allocated since the last sampled backtrace
+    size_t sample_accumulator;
+};
+
+static _Thread_local struct profile_counters profile_counters;
+
+static struct {
+    _Atomic uint64_t calls[PROFILE_ENTRY_POINTS];
+    _Atomic uint64_t bytes[PROFILE_ENTRY_POINTS];
+    _Atomic uint64_t sizes[PROFILE_ENTRY_POINTS][PROFILE_SIZE_BUCKETS];
+} profile_totals;
+
+#define PROFILE_SAMPLE_DEPTH 16
+#define PROFILE_SAMPLE_SLOTS 64
+
+struct profile_sample {
+    int depth;
+    size_t bytes;
+    void *frames[PROFILE_SAMPLE_DEPTH];
+};
+
+static struct profile_sample profile_samples[PROFILE_SAMPLE_SLOTS];
+static _Atomic uint32_t profile_sample_count = 0;
+
+void profile_count(enum profile_entry_point entry_point) {
+    profile_counters.calls[entry_point] += 1;
+}
+
+static int profile_size_bucket(size_t bytes) {
+    int bucket = 0;
+    while (bytes > 1 && bucket < PROFILE_SIZE_BUCKETS - 1) {
+        bytes >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void profile_sample_backtrace(size_t bytes) {
+    uint32_t index =
+        atomic_fetch_add_explicit(&profile_sample_count, 1, memory_order_relaxed);
+    struct profile_sample *sample =
+        &profile_samples[index % PROFILE_SAMPLE_SLOTS];
+    sample->bytes = bytes;
+    sample->depth = backtrace(sample->frames, PROFILE_SAMPLE_DEPTH);
+}
+
+void profile_alloc(enum profile_entry_point entry_point, size_t bytes) {
+    profile_counters.calls[entry_point] += 1;
+    profile_counters.bytes[entry_point] += bytes;
+    profile_counters.sizes[entry_point][profile_size_bucket(bytes)] += 1;
+
+    profile_counters.sample_accumulator += bytes;
+    if (profile_counters.sample_accumulator >= PROFILE_SAMPLE_BYTES) {
+        profile_counters.sample_accumulator = 0;
+        profile_sample_backtrace(bytes);
+    }
+}
+
+void profile_flush(void) {
+    int ep, bucket;
+    for (ep = 0; ep < PROFILE_ENTRY_POINTS; ep++) {
+        atomic_fetch_add_explicit(&profile_totals.calls[ep],
+                                  profile_counters.calls[ep], memory_order_relaxed);
+        atomic_fetch_add_explicit(&profile_totals.bytes[ep],
+                                  profile_counters.bytes[ep], memory_order_relaxed);
+        profile_counters.calls[ep] = 0;
+        profile_counters.bytes[ep] = 0;
+        for (bucket = 0; bucket < PROFILE_SIZE_BUCKETS; bucket++) {
+            atomic_fetch_add_explicit(&profile_totals.sizes[ep][bucket],
+                                      profile_counters.sizes[ep][bucket],
+                                      memory_order_relaxed);
+            profile_counters.sizes[ep][bucket] = 0;
+        }
+    }
+}
+
+static void profile_dump(void) {
+    profile_flush();
+
+    fprintf(stderr, "-- runtime entry point profile --\n");
+    int ep, bucket;
+    for (ep = 0; ep < PROFILE_ENTRY_POINTS; ep++) {
+        uint64_t calls =
+            atomic_load_explicit(&profile_totals.calls[ep], memory_order_relaxed);
+        if (calls == 0) {
+            continue;
+        }
+        uint64_t bytes =
+            atomic_load_explicit(&profile_totals.bytes[ep], memory_order_relaxed);
+        fprintf(stderr, "%-28s %12llu calls %14llu bytes\n",
+                profile_entry_point_names[ep], (unsigned long long)calls,
+                (unsigned long long)bytes);
+        for (bucket = 0; bucket < PROFILE_SIZE_BUCKETS; bucket++) {
+            uint64_t count = atomic_load_explicit(&profile_totals.sizes[ep][bucket],
+                                                  memory_order_relaxed);
+            if (count > 0) {
+                fprintf(stderr, "    <= %6u bytes: %llu\n", 1u << bucket,
+                        (unsigned long long)count);
+            }
+        }
+    }
+
+    uint32_t samples =
+        atomic_load_explicit(&profile_sample_count, memory_order_relaxed);
+    if (samples == 0) {
+        return;
+    }
+    fprintf(stderr, "-- sampled allocation backtraces (1 per %u bytes) --\n",
+            (unsigned)PROFILE_SAMPLE_BYTES);
+    uint32_t slots =
+        samples < PROFILE_SAMPLE_SLOTS ? samples : PROFILE_SAMPLE_SLOTS;
+    uint32_t i;
+    for (i = 0; i < slots; i++) {
+        struct profile_sample *sample = &profile_samples[i];
+        fprintf(stderr, "sample #%u (%zu bytes):\n", i, sample->bytes);
+        backtrace_symbols_fd(sample->frames, sample->depth, fileno(stderr));
+    }
+}
+
+void profile_init(void) {
+    atexit(profile_dump);
+}
+
+#endif // JRT_PROFILE
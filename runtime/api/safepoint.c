@@ -0,0 +1,94 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "../lib/safepoint.h"
+#include "../lib/thread.h"
+#include "../lib/gc.h"
+#include "../lib/utils.h"
+
+// the poll target; its own alignment granule, so arming it protects
+// nothing else. It sits in the data segment the collector scans, but
+// only ever holds zeros, so the scan finds no pointers in it.
+char _Jrt_safepoint_page[4096] __attribute__((aligned(4096)));
+
+// set before arming and cleared after disarming; parked threads spin
+// on this flag rather than on the page itself (reading the armed page
+// would just fault again)
+static _Atomic uint32_t safepoint_armed = 0;
+
+// threads currently parked in _Jrt_safepoint_slow
+static _Atomic uint32_t safepoint_parked = 0;
+
+static struct sigaction safepoint_prev_segv;
+
+// only nanosleep below: the wait loops run inside a signal handler,
+// where pthread primitives are off-limits
+static void safepoint_wait_tick(void) {
+    struct timespec ts = {0, 100000}; // 100us
+    nanosleep(&ts, NULL);
+}
+
+void _Jrt_safepoint_slow(void) {
+    atomic_store_explicit(&thread_state_tls, THREAD_STATE_SAFEPOINT,
+                          memory_order_release);
+    atomic_fetch_add_explicit(&safepoint_parked, 1, memory_order_acq_rel);
+    while (atomic_load_explicit(&safepoint_armed, memory_order_acquire)) {
+        safepoint_wait_tick();
+    }
+    atomic_fetch_sub_explicit(&safepoint_parked, 1, memory_order_acq_rel);
+    atomic_store_explicit(&thread_state_tls, THREAD_STATE_RUNNING,
+                          memory_order_release);
+}
+
+static void safepoint_on_fault(int signum, siginfo_t *info, void *context) {
+    (void)context;
+    uint8_t *addr = (uint8_t *)info->si_addr;
+    if (addr < (uint8_t *)_Jrt_safepoint_page ||
+        addr >= (uint8_t *)_Jrt_safepoint_page + sizeof(_Jrt_safepoint_page)) {
+        // a genuine fault: restore the default disposition and return,
+        // so re-executing the faulting access crashes the usual way
+        signal(signum, SIG_DFL);
+        return;
+    }
+    _Jrt_safepoint_slow();
+    // returning re-executes the poll, which succeeds now that the
+    // page is readable again
+}
+
+void safepoint_init(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = safepoint_on_fault;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    ensure(sigaction(SIGSEGV, &action, &safepoint_prev_segv));
+#ifdef __MACH__
+    // protection faults surface as SIGBUS there
+    ensure(sigaction(SIGBUS, &action, NULL));
+#endif
+}
+
+void safepoint_begin(void) {
+    atomic_store_explicit(&safepoint_armed, 1, memory_order_release);
+    ensure(mprotect(_Jrt_safepoint_page, sizeof(_Jrt_safepoint_page),
+                    PROT_NONE));
+    // the count is re-read every pass: a mutator may detach (thread
+    // exit) instead of reaching a poll
+    while (atomic_load_explicit(&safepoint_parked, memory_order_acquire) + 1 <
+           gc_mutator_count()) {
+        safepoint_wait_tick();
+    }
+}
+
+void safepoint_end(void) {
+    // reopen the page before releasing anyone, so the re-executed
+    // polls of waking threads succeed
+    ensure(mprotect(_Jrt_safepoint_page, sizeof(_Jrt_safepoint_page),
+                    PROT_READ));
+    atomic_store_explicit(&safepoint_armed, 0, memory_order_release);
+}
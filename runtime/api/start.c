@@ -6,9 +6,30 @@
 #include "../lib/array.h"
 #include "../lib/string.h"
 #include "../lib/thread.h"
+#include "../lib/stream.h"
+#include "../lib/alloc.h"
+#include "../lib/gc.h"
+#include "../lib/safepoint.h"
+#include "../lib/metadata.h"
+#include "../lib/lockprof.h"
+#include "../lib/profile.h"
+
+static void flush_output_streams(void) {
+    stream_flush(&stream_stdout);
+}
 
 uint32_t _Jrt_start(uint32_t argc, char **argv, void (*static_main_method)(ref_t args)) {
+    // runtime initialization phase: name the main thread, reserve
+    // the heap, attach the main mutator, and register teardown hooks
+    // before the first allocation
     thread_name_set("main");
+    alloc_init();
+    metadata_init();
+    gc_init(&argc);
+    safepoint_init();
+    lockprof_init();
+    profile_init();
+    atexit(flush_output_streams);
 
     ref_t args;
     if (argc > 0) {
@@ -24,5 +45,7 @@ uint32_t _Jrt_start(uint32_t argc, char **argv, void (*static_main_method)(ref_t
 
     static_main_method(args);
 
+    flush_output_streams();
+
     return 0;
 }
@@ -0,0 +1,61 @@
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <errno.h>
+#include <memory.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "../lib/stream.h"
+#include "../lib/utils.h"
+
+stream_t stream_stdout = {.fd = STDOUT_FILENO, .len = 0};
+
+static void stream_writev_all(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PANIC("Failed to write to output stream. Aborting.");
+        }
+        while (iovcnt > 0 && (size_t)written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+void stream_flush(stream_t *stream) {
+    if (stream->len == 0) {
+        return;
+    }
+    struct iovec iov = {stream->buffer, stream->len};
+    stream_writev_all(stream->fd, &iov, 1);
+    stream->len = 0;
+}
+
+void stream_write(stream_t *stream, const void *bytes, size_t len) {
+    if (len >= STREAM_BUFFER_SIZE) {
+        // flush the buffered bytes and the oversized payload in one
+        // vectored write, skipping the copy into the buffer
+        struct iovec iov[2] = {{stream->buffer, stream->len}, {(void *)bytes, len}};
+        if (stream->len > 0) {
+            stream_writev_all(stream->fd, iov, 2);
+        } else {
+            stream_writev_all(stream->fd, &iov[1], 1);
+        }
+        stream->len = 0;
+        return;
+    }
+    if (STREAM_BUFFER_SIZE - stream->len < len) {
+        stream_flush(stream);
+    }
+    memcpy(&stream->buffer[stream->len], bytes, len);
+    stream->len += len;
+}
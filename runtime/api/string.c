@@ -1,10 +1,235 @@
 #define _GNU_SOURCE 1
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../lib/ref.h"
 #include "../lib/string.h"
+#include "../lib/profile.h"
+#include "../lib/utils.h"
+
+static uint32_t string_hash_bytes(const char *data, uint32_t length);
+int32_t _Jrt_string_hash(ref_t ref);
+
+// The intern table is a fixed-size open-addressing hash table of bare
+// object pointers. Slots go from NULL to a string object exactly once
+// (CAS to insert, never removed), so readers only need an acquire load
+// to see the fully constructed string behind a published pointer. The
+// table lives in the data segment, which the collector scans
+// conservatively as a root set, so interned strings stay alive.
+#define INTERN_TABLE_SIZE (1 << 16)
+#define INTERN_MAX_PROBE 32
+
+static _Atomic(void *) intern_table[INTERN_TABLE_SIZE];
+
+// looks up the canonical string for the given bytes, allocating and
+// inserting when absent; bounded linear probing keeps the worst case
+// flat — if a neighborhood fills up the string is simply left
+// uninterned, which is correct (identity is a fast path, not a
+// guarantee)
+static ref_t string_intern_bytes(const char *bytes, uint32_t length) {
+    uint32_t hash = string_hash_bytes(bytes, length);
+    ref_t created = {0};
+    uint32_t probe;
+    for (probe = 0; probe < INTERN_MAX_PROBE; probe++) {
+        _Atomic(void *) *slot =
+            &intern_table[(hash + probe) & (INTERN_TABLE_SIZE - 1)];
+        void *existing = atomic_load_explicit(slot, memory_order_acquire);
+        if (existing == NULL) {
+            if (created.object == NULL) {
+                created = string_new_with_length(bytes, length);
+                STRING_BASE_PTR(created)->hash = hash;
+            }
+            if (atomic_compare_exchange_strong_explicit(
+                    slot, &existing, created.object, memory_order_release,
+                    memory_order_acquire)) {
+                return created;
+            }
+            // lost the race; `existing` now holds the winner's pointer
+        }
+        ref_t candidate = string_ref(existing);
+        struct string_base *cand_base = STRING_BASE_PTR(candidate);
+        if (cand_base->length == length &&
+            memcmp(STRING_DATA_PTR(candidate), bytes, length) == 0) {
+            return candidate;
+        }
+    }
+    if (created.object != NULL) {
+        return created;
+    }
+    return string_new_with_length(bytes, length);
+}
 
 ref_t _Jrt_ldstr(void *bytes) {
-    return string_new(bytes);
+    PROFILE_COUNT(PROFILE_LDSTR);
+    const char *chars = (const char *)bytes;
+    return string_intern_bytes(chars, (uint32_t)strlen(chars));
+}
+
+// per-ldc-site cache: the compiler emits one pointer-sized slot per
+// string constant, so after the first execution a hot site resolves
+// its constant with a single load instead of hashing into the table
+ref_t _Jrt_ldstr_cached(void *bytes, void *cache_slot) {
+    _Atomic(void *) *slot = (_Atomic(void *) *)cache_slot;
+    void *cached = atomic_load_explicit(slot, memory_order_acquire);
+    if (cached != NULL) {
+        return string_ref(cached);
+    }
+    ref_t interned = _Jrt_ldstr(bytes);
+    atomic_store_explicit(slot, interned.object, memory_order_release);
+    return interned;
+}
+
+// String.intern(): canonicalizes through the same table as ldc; the
+// receiver itself becomes the canonical copy when its content is new
+ref_t _Jrt_string_intern(ref_t ref) {
+    struct string_base *base = STRING_BASE_PTR(ref);
+    const char *data = STRING_DATA_PTR(ref);
+    uint32_t hash = (uint32_t)_Jrt_string_hash(ref);
+    uint32_t probe;
+    for (probe = 0; probe < INTERN_MAX_PROBE; probe++) {
+        _Atomic(void *) *slot =
+            &intern_table[(hash + probe) & (INTERN_TABLE_SIZE - 1)];
+        void *existing = atomic_load_explicit(slot, memory_order_acquire);
+        if (existing == NULL) {
+            if (atomic_compare_exchange_strong_explicit(
+                    slot, &existing, ref.object, memory_order_release,
+                    memory_order_acquire)) {
+                return ref;
+            }
+        }
+        ref_t candidate = string_ref(existing);
+        struct string_base *cand_base = STRING_BASE_PTR(candidate);
+        if (cand_base->length == base->length &&
+            memcmp(STRING_DATA_PTR(candidate), data, base->length) == 0) {
+            return candidate;
+        }
+    }
+    return ref;
+}
+
+// content equality with early exits on the cached header fields: two
+// strings of different lengths, or with two different cached hashes,
+// can't be equal without touching the bytes; the byte compare itself
+// is libc's vectorized memcmp
+int32_t _Jrt_string_equals(ref_t a, ref_t b) {
+    if (a.object == b.object) {
+        return 1;
+    }
+    if (a.object == NULL || b.object == NULL) {
+        return 0;
+    }
+    struct string_base *a_base = STRING_BASE_PTR(a);
+    struct string_base *b_base = STRING_BASE_PTR(b);
+    if (a_base->length != b_base->length) {
+        return 0;
+    }
+    if (a_base->hash != 0 && b_base->hash != 0 && a_base->hash != b_base->hash) {
+        return 0;
+    }
+    return memcmp(STRING_DATA_PTR(a), STRING_DATA_PTR(b), a_base->length) == 0;
+}
+
+// 31^1 .. 31^8 (mod 2^32), highest power first (see array.c)
+static const uint32_t STRING_HASH_POW31[8] = {
+    1742810335u, 887503681u, 28629151u, 923521u, 29791u, 961u, 31u, 1u,
+};
+#define STRING_HASH_POW31_8 2487512833u
+
+// the serial h = 31*h + c recurrence split so the per-byte multiplies
+// are independent and the inner loop vectorizes
+JRT_BULKOP static uint32_t string_hash_bytes(const char *data, uint32_t length) {
+    uint32_t hash = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint32_t chunk = 0;
+        uint32_t j;
+        for (j = 0; j < 8; j++) {
+            chunk += (uint32_t)(uint8_t)data[i + j] * STRING_HASH_POW31[j];
+        }
+        hash = hash * STRING_HASH_POW31_8 + chunk;
+    }
+    for (; i < length; i++) {
+        hash = hash * 31 + (uint8_t)data[i];
+    }
+    return hash;
+}
+
+// String.hashCode with the same caching protocol as string_hash: the
+// header slot holds the memoized value, 0 meaning not yet computed
+// (strings that genuinely hash to 0 just recompute, like in the JDK)
+int32_t _Jrt_string_hash(ref_t ref) {
+    struct string_base *base = STRING_BASE_PTR(ref);
+    uint32_t hash = base->hash;
+    if (hash == 0) {
+        hash = string_hash_bytes(STRING_DATA_PTR(ref), base->length);
+        base->hash = hash;
+    }
+    return (int32_t)hash;
+}
+
+// String.indexOf(String, int) over the utf-8 bytes; memmem is libc's
+// vectorized two-way search
+int32_t _Jrt_string_index_of(ref_t haystack, ref_t needle, int32_t from) {
+    struct string_base *hay_base = STRING_BASE_PTR(haystack);
+    struct string_base *needle_base = STRING_BASE_PTR(needle);
+    uint32_t start = from < 0 ? 0 : (uint32_t)from;
+    if (needle_base->length == 0) {
+        return start > hay_base->length ? (int32_t)hay_base->length : (int32_t)start;
+    }
+    if (start >= hay_base->length ||
+        needle_base->length > hay_base->length - start) {
+        return -1;
+    }
+    const char *data = STRING_DATA_PTR(haystack);
+    const char *found = memmem(data + start, hay_base->length - start,
+                               STRING_DATA_PTR(needle), needle_base->length);
+    if (found == NULL) {
+        return -1;
+    }
+    return (int32_t)(found - data);
+}
+
+// String.indexOf(int, int): ASCII code points take the memchr fast
+// path; anything wider is encoded to utf-8 and searched as a
+// substring, consistent with the byte indices used throughout
+int32_t _Jrt_string_index_of_char(ref_t haystack, int32_t ch, int32_t from) {
+    struct string_base *base = STRING_BASE_PTR(haystack);
+    uint32_t start = from < 0 ? 0 : (uint32_t)from;
+    if (start >= base->length) {
+        return -1;
+    }
+    const char *data = STRING_DATA_PTR(haystack);
+    const char *found;
+    if ((uint32_t)ch < 0x80) {
+        found = memchr(data + start, ch, base->length - start);
+    } else {
+        char encoded[4];
+        size_t encoded_len;
+        uint32_t cp = (uint32_t)ch;
+        if (cp < 0x800) {
+            encoded[0] = (char)(0xc0 | (cp >> 6));
+            encoded[1] = (char)(0x80 | (cp & 0x3f));
+            encoded_len = 2;
+        } else if (cp < 0x10000) {
+            encoded[0] = (char)(0xe0 | (cp >> 12));
+            encoded[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+            encoded[2] = (char)(0x80 | (cp & 0x3f));
+            encoded_len = 3;
+        } else if (cp < 0x110000) {
+            encoded[0] = (char)(0xf0 | (cp >> 18));
+            encoded[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+            encoded[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+            encoded[3] = (char)(0x80 | (cp & 0x3f));
+            encoded_len = 4;
+        } else {
+            return -1; // not a valid code point
+        }
+        found = memmem(data + start, base->length - start, encoded, encoded_len);
+    }
+    if (found == NULL) {
+        return -1;
+    }
+    return (int32_t)(found - data);
 }
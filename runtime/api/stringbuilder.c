@@ -0,0 +1,67 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../lib/ref.h"
+#include "../lib/string.h"
+#include "../lib/stringbuilder.h"
+
+struct ref_vtable_base _ZTVN4java4lang13StringBuilderE;
+
+// entry points the compiler lowers StringBuilder invokevirtual sites
+// onto (see gen_stringbuilder_intrinsic in the backend); append
+// returns the receiver so chained append calls keep their value
+
+ref_t _Jrt_stringbuilder_init(ref_t this) {
+    stringbuilder_init(this);
+    return this;
+}
+
+ref_t _Jrt_stringbuilder_append_string(ref_t this, ref_t string) {
+    stringbuilder_append_bytes(this, STRING_DATA_PTR(string), string_length(string));
+    return this;
+}
+
+ref_t _Jrt_stringbuilder_append_int(ref_t this, int32_t value) {
+    char digits[12];
+    int len = snprintf(digits, sizeof(digits), "%d", value);
+    stringbuilder_append_bytes(this, digits, (uint32_t)len);
+    return this;
+}
+
+ref_t _Jrt_stringbuilder_append_long(ref_t this, int64_t value) {
+    char digits[21];
+    int len = snprintf(digits, sizeof(digits), "%lld", (long long)value);
+    stringbuilder_append_bytes(this, digits, (uint32_t)len);
+    return this;
+}
+
+// chars are UTF-16 code units; encode to the utf-8 bytes the buffer
+// (and the string layout) uses, like String.indexOf(int) does
+ref_t _Jrt_stringbuilder_append_char(ref_t this, uint16_t value) {
+    char encoded[3];
+    uint32_t len;
+    if (value < 0x80) {
+        encoded[0] = (char)value;
+        len = 1;
+    } else if (value < 0x800) {
+        encoded[0] = (char)(0xc0 | (value >> 6));
+        encoded[1] = (char)(0x80 | (value & 0x3f));
+        len = 2;
+    } else {
+        encoded[0] = (char)(0xe0 | (value >> 12));
+        encoded[1] = (char)(0x80 | ((value >> 6) & 0x3f));
+        encoded[2] = (char)(0x80 | (value & 0x3f));
+        len = 3;
+    }
+    stringbuilder_append_bytes(this, encoded, len);
+    return this;
+}
+
+ref_t _Jrt_stringbuilder_to_string(ref_t this) {
+    return stringbuilder_to_string(this);
+}
+
+void _ZN4java4lang13StringBuilder4initIu9J8cc45093EEvv(ref_t this) {
+    stringbuilder_init(this);
+}
@@ -5,16 +5,25 @@
 #include <math.h>
 
 #include "../lib/ref.h"
+#include "../lib/object.h"
+#include "../lib/string.h"
+#include "../lib/stream.h"
 #include "../lib/utils.h"
 
 struct vtable_printstream {
     uint32_t length;
+    struct ref_class_metadata *metadata;
     void *padding[43];
     void (*println_string)(ref_t, ref_t);
 };
 
+// System.out goes through the buffered stream from lib/stream.h
+// instead of per-line stdio calls; _Jrt_start flushes it on exit.
+// Further print/println overloads can be wired in once their slots in
+// the compiler-emitted PrintStream vtable are known.
 static void printstream_println_string_stub(ref_t _this, ref_t string) {
-    puts((const char *)string.object);
+    stream_write(&stream_stdout, STRING_DATA_PTR(string), string_length(string));
+    stream_write(&stream_stdout, "\n", 1);
 }
 
 static struct vtable_printstream VTABLE_PRINTSTREAM = {
@@ -22,19 +31,23 @@ static struct vtable_printstream VTABLE_PRINTSTREAM = {
     .println_string = printstream_println_string_stub
 };
 
+#ifdef JRT_COMPRESSED_REFS
+static struct object_base SYSTEM_OUT_OBJECT = {
+    .vtable = &VTABLE_PRINTSTREAM
+};
+
+ref_t _ZN4java4lang6System3outE = {
+    .object = &SYSTEM_OUT_OBJECT
+};
+#else
 ref_t _ZN4java4lang6System3outE = {
     .object = NULL,
     .vtable = &VTABLE_PRINTSTREAM
 };
-
-struct ref_vtable_base _ZTVN4java4lang13StringBuilderE;
+#endif
 
 struct ref_vtable_base _ZTVN4java4lang24IllegalArgumentExceptionE;
 
-void _ZN4java4lang13StringBuilder4initIu9J8cc45093EEvv(ref_t _this) {
-    trap_unimplemented("java.lang.StringBuilder.<init>");
-}
-
 void _ZN4java4lang24IllegalArgumentException4initIu9Jffb6fc97EEvN4java4lang6StringE(ref_t _this, ref_t _string) {
     trap_unimplemented("java.lang.IllegalArgumentException.<init>");
 }
@@ -0,0 +1,143 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "../lib/thread.h"
+#include "../lib/alloc.h"
+#include "../lib/gc.h"
+#include "../lib/profile.h"
+#include "../lib/utils.h"
+
+_Thread_local _Atomic uint32_t thread_state_tls = THREAD_STATE_RUNNING;
+
+_Thread_local uint32_t thread_id_tls = 0;
+
+static _Atomic uint32_t thread_id_counter = 1;
+
+uint32_t thread_id_assign(void) {
+    return atomic_fetch_add_explicit(&thread_id_counter, 1, memory_order_relaxed);
+}
+
+#define THREAD_STACK_SIZE (1024 * 1024)
+#define THREAD_GUARD_SIZE 4096
+
+struct thread *thread_registry = NULL;
+
+// stacks of joined threads, recycled so repeated thread creation
+// doesn't pay mmap costs
+struct thread_stack {
+    struct thread_stack *next;
+};
+
+static struct thread_stack *thread_stack_cache = NULL;
+
+static _Atomic uint32_t thread_start_counter = 0;
+
+static pthread_mutex_t thread_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void thread_registry_lock(void) {
+    ensure(pthread_mutex_lock(&thread_mutex));
+}
+
+void thread_registry_unlock(void) {
+    ensure(pthread_mutex_unlock(&thread_mutex));
+}
+
+// caller must hold the registry lock
+static void *thread_stack_acquire(void) {
+    struct thread_stack *cached = thread_stack_cache;
+    if (cached != NULL) {
+        thread_stack_cache = cached->next;
+        // the freelist node sits just past the guard page
+        return (uint8_t *)cached - THREAD_GUARD_SIZE;
+    }
+    void *stack = mmap(NULL, THREAD_STACK_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) {
+        PANIC("Failed to allocate thread stack. Aborting.");
+    }
+    // guard page at the low end, where the stack grows towards
+    ensure(mprotect(stack, THREAD_GUARD_SIZE, PROT_NONE));
+    return stack;
+}
+
+// caller must hold the registry lock
+static void thread_stack_release(void *stack) {
+    // the guard page stays in place across reuses; the freelist node
+    // lives just past it, in the usable part of the stack
+    struct thread_stack *cached = (struct thread_stack *)((uint8_t *)stack + THREAD_GUARD_SIZE);
+    cached->next = thread_stack_cache;
+    thread_stack_cache = cached;
+}
+
+static void *thread_entry(void *arg) {
+    struct thread *thread = arg;
+    thread_name_set(thread->name);
+    gc_mutator_attach();
+    thread->entry(thread->object);
+    // hand the TLAB's chunk back for the sweeper to account; must
+    // happen under the alloc lock and before detaching, or a collector
+    // already sweeping the chunk races the unlocked limit store
+    alloc_lock();
+    alloc_tlab_retire();
+    alloc_unlock();
+    gc_mutator_detach();
+    profile_flush();
+    return NULL;
+}
+
+void _Jrt_thread_start(ref_t thread_obj, void (*entry)(ref_t)) {
+    struct thread *thread = malloc(sizeof(struct thread));
+    if (thread == NULL) {
+        PANIC("Failed to allocate thread record. Aborting.");
+    }
+    thread->entry = entry;
+    thread->object = thread_obj;
+    uint32_t number =
+        atomic_fetch_add_explicit(&thread_start_counter, 1, memory_order_relaxed);
+    snprintf(thread->name, sizeof(thread->name), "Thread-%u", number);
+
+    thread_registry_lock();
+    thread->stack = thread_stack_acquire();
+    thread->next = thread_registry;
+    thread_registry = thread;
+    thread_registry_unlock();
+
+    pthread_attr_t attr;
+    ensure(pthread_attr_init(&attr));
+    ensure(pthread_attr_setstack(&attr, (uint8_t *)thread->stack + THREAD_GUARD_SIZE,
+                                 THREAD_STACK_SIZE - THREAD_GUARD_SIZE));
+    ensure(pthread_create(&thread->pthread, &attr, thread_entry, thread));
+    ensure(pthread_attr_destroy(&attr));
+}
+
+void _Jrt_thread_join(ref_t thread_obj) {
+    thread_registry_lock();
+    struct thread **link = &thread_registry;
+    struct thread *thread = NULL;
+    while (*link != NULL) {
+        if ((*link)->object.object == thread_obj.object) {
+            thread = *link;
+            *link = thread->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    thread_registry_unlock();
+
+    // already joined (or never started): join returns immediately
+    if (thread == NULL) {
+        return;
+    }
+
+    ensure(pthread_join(thread->pthread, NULL));
+
+    thread_registry_lock();
+    thread_stack_release(thread->stack);
+    thread_registry_unlock();
+    free(thread);
+}
@@ -9,21 +9,76 @@
 #include "../lib/array.h"
 #include "../lib/string.h"
 #include "../lib/thread.h"
+#include "../lib/profile.h"
+#include "../lib/utils.h"
 
 static uint64_t EXCEPTION_CLASS = (uint64_t)"__JRT_EXCEPTION";
 
-static int THREADNAME_MAX_LEN = 32;
-static int BACKTRACE_MAX_LEN = 64;
+#define THREADNAME_MAX_LEN 32
+#define BACKTRACE_MAX_LEN 64
+#define EXCEPTION_POOL_SIZE 4
 
 struct exception {
     struct _Unwind_Exception unwind;
+    int pooled;
+    int in_use;
+    void *throw_site;
+    // raw return addresses only; symbolization is deferred to
+    // exception_print, so exceptions that are caught and never
+    // printed don't pay for symbol resolution
     int backtrace_len;
-    char **backtrace;
+    void *backtrace[BACKTRACE_MAX_LEN];
 };
 
+// Fast path for hot try-catch: backtrace() is itself a full unwind
+// of the stack, so every throw pays for two complete walks even when
+// a handler two frames up swallows the exception. Throw sites whose
+// exceptions have been observed to get caught are remembered in a
+// small per-thread direct-mapped cache and skip the eager capture;
+// if such a throw unexpectedly reaches the end of the stack, the
+// backtrace is captured then, while the stack is still intact
+// (_Unwind_RaiseException returns to us without unwinding it).
+#define THROW_SITE_CACHE_SIZE 16
+
+static _Thread_local void *throw_site_cache[THROW_SITE_CACHE_SIZE];
+
+static void **throw_site_slot(void *site) {
+    return &throw_site_cache[((uintptr_t)site >> 4) % THROW_SITE_CACHE_SIZE];
+}
+
+// per-thread pool of preallocated exceptions; throws deeper than the
+// pool (nested throws during unwinding) fall back to malloc
+static _Thread_local struct exception exception_pool[EXCEPTION_POOL_SIZE];
+
+static struct exception *exception_acquire(void) {
+    int i;
+    for (i = 0; i < EXCEPTION_POOL_SIZE; i++) {
+        if (!exception_pool[i].in_use) {
+            exception_pool[i].pooled = 1;
+            exception_pool[i].in_use = 1;
+            return &exception_pool[i];
+        }
+    }
+    struct exception *exc = malloc(sizeof(struct exception));
+    if (exc == NULL) {
+        PANIC("Failed to allocate exception. Aborting.");
+    }
+    exc->pooled = 0;
+    exc->in_use = 1;
+    return exc;
+}
+
 static void exception_cleanup(_Unwind_Reason_Code reason, struct _Unwind_Exception *exc) {
-    free(((struct exception *)exc)->backtrace);
-    free(exc);
+    struct exception *exception = (struct exception *)exc;
+    // the cleanup hook only runs for exceptions a handler disposed
+    // of, so this site's throws are being caught: take the fast path
+    // from now on
+    *throw_site_slot(exception->throw_site) = exception->throw_site;
+    if (exception->pooled) {
+        exception->in_use = 0;
+    } else {
+        free(exception);
+    }
 }
 
 static void exception_print(struct exception *exc) {
@@ -34,28 +89,38 @@ static void exception_print(struct exception *exc) {
         fprintf(stderr, "Exception in unknown thread\n");
     }
 
+    char **symbols = backtrace_symbols(exc->backtrace, exc->backtrace_len);
     int i;
     for (i = 0; i < exc->backtrace_len; i++) {
-        fprintf(stderr, "%s\n", exc->backtrace[i]);
-    } 
+        fprintf(stderr, "%s\n", symbols[i]);
+    }
+    free(symbols);
 }
 
 void _Jrt_throw(ref_t _throwable) {
-    // allocate and initialize exception
-    struct exception *exc = malloc(sizeof(struct exception));
+    PROFILE_COUNT(PROFILE_THROW);
+    struct exception *exc = exception_acquire();
     exc->unwind.exception_class = EXCEPTION_CLASS;
     exc->unwind.exception_cleanup = exception_cleanup;
+    exc->throw_site = __builtin_return_address(0);
 
-    // capture stack trace
-    void *stack[BACKTRACE_MAX_LEN];
-    int stack_len = backtrace(stack, BACKTRACE_MAX_LEN);
-    exc->backtrace_len = stack_len;
-    exc->backtrace = backtrace_symbols(stack, stack_len);
+    // capture raw return addresses only, and not at all for sites
+    // known to get caught (see throw_site_cache above)
+    if (*throw_site_slot(exc->throw_site) == exc->throw_site) {
+        exc->backtrace_len = 0;
+    } else {
+        exc->backtrace_len = backtrace(exc->backtrace, BACKTRACE_MAX_LEN);
+    }
 
     // unwind and handle any errors
     _Unwind_Reason_Code code = _Unwind_RaiseException((struct _Unwind_Exception *)exc);
     switch (code) {
     case _URC_END_OF_STACK:
+        // a fast-path throw escaped after all; the stack below us is
+        // untouched, so the deferred capture still sees every frame
+        if (exc->backtrace_len == 0) {
+            exc->backtrace_len = backtrace(exc->backtrace, BACKTRACE_MAX_LEN);
+        }
         exception_print(exc);
         exit(EXIT_FAILURE);
     default:
@@ -0,0 +1,215 @@
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "../lib/ref.h"
+#include "../lib/object.h"
+#include "../lib/array.h"
+#include "../lib/extern.h"
+#include "../lib/gc.h"
+#include "../lib/utils.h"
+
+// normally emitted by the compiler; nothing here dispatches through
+// it, so empty storage satisfies the allocation paths
+struct object_base _ZTVN4java4lang6ObjectE;
+
+// Microbenchmarks for the runtime's hot entry points. Build and run
+// with `make bench`; each line reports nanoseconds per operation so
+// regressions show up as a diff against a previous run.
+
+ref_t _Jrt_object_new(uint64_t size, void *vtable);
+ref_t _Jrt_array_new_4(uint32_t count);
+void *_Jrt_object_vtable_lookup(ref_t ref, uint64_t index);
+void *_Jrt_object_itable_lookup(ref_t ref, void *iface, uint64_t index);
+void _Jrt_object_monitorenter(ref_t ref);
+void _Jrt_object_monitorexit(ref_t ref);
+void _ZN4java4lang6System9arraycopyIu9Jb7e57d76EEvN4java4lang6ObjectEiN4java4lang6ObjectEii(
+    ref_t src, int32_t src_pos, ref_t dest, int32_t dest_pos, int32_t length);
+
+// defined in bench/catch.cc: throws `throwable` and catches it one
+// frame up, completing a full raise/unwind/catch round trip
+int bench_throw_catch(ref_t throwable);
+
+// accumulating into a volatile sink keeps the measured calls live
+static volatile uint64_t bench_sink;
+
+static uint64_t now_nsec(void) {
+    struct timespec ts;
+    ensure(clock_gettime(CLOCK_MONOTONIC, &ts));
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t iterations, uint64_t elapsed_nsec) {
+    printf("%-36s %10.1f ns/op  (%llu ops)\n", name,
+           (double)elapsed_nsec / (double)iterations,
+           (unsigned long long)iterations);
+}
+
+// a vtable shaped like the compiler emits: method count, metadata,
+// method slots, then the itable
+struct bench_vtable {
+    uint32_t length;
+    struct ref_class_metadata *metadata;
+    void *methods[2];
+    uint32_t icount;
+    uint32_t padding;
+    struct ref_itable_entry entries[1];
+};
+
+static int bench_method_marker;
+static int bench_iface_marker;
+
+static struct bench_vtable bench_vtable = {
+    .length = 2,
+    .metadata = NULL,
+    .methods = {&bench_method_marker, &bench_method_marker},
+    .icount = 1,
+    .entries = {{.interface = &bench_iface_marker, .offset = 0}},
+};
+
+static ref_t bench_object_ref(void) {
+    return object_new(16, &bench_vtable);
+}
+
+static void bench_object_new(void) {
+    const uint64_t iterations = 4 * 1000 * 1000;
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        ref_t ref = _Jrt_object_new(16, &bench_vtable);
+        bench_sink += (uintptr_t)ref.object;
+    }
+    report("_Jrt_object_new (16 byte body)", iterations, now_nsec() - start);
+}
+
+static void bench_array_new(void) {
+    const uint64_t iterations = 2 * 1000 * 1000;
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        ref_t ref = _Jrt_array_new_4(64);
+        bench_sink += (uintptr_t)ref.object;
+    }
+    report("_Jrt_array_new_4 (int[64])", iterations, now_nsec() - start);
+}
+
+static void bench_vtable_lookup(void) {
+    const uint64_t iterations = 100 * 1000 * 1000;
+    ref_t ref = bench_object_ref();
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        bench_sink += (uintptr_t)_Jrt_object_vtable_lookup(ref, 1);
+    }
+    report("_Jrt_object_vtable_lookup", iterations, now_nsec() - start);
+}
+
+static void bench_itable_lookup(void) {
+    const uint64_t iterations = 100 * 1000 * 1000;
+    ref_t ref = bench_object_ref();
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        bench_sink += (uintptr_t)_Jrt_object_itable_lookup(ref, &bench_iface_marker, 0);
+    }
+    report("_Jrt_object_itable_lookup", iterations, now_nsec() - start);
+}
+
+static void bench_monitor_uncontended(void) {
+    const uint64_t iterations = 20 * 1000 * 1000;
+    ref_t ref = bench_object_ref();
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        _Jrt_object_monitorenter(ref);
+        _Jrt_object_monitorexit(ref);
+    }
+    report("monitorenter/exit (uncontended)", iterations, now_nsec() - start);
+}
+
+struct contender {
+    ref_t ref;
+    _Atomic int stop;
+};
+
+static void *contender_main(void *arg) {
+    struct contender *contender = arg;
+    while (!atomic_load_explicit(&contender->stop, memory_order_relaxed)) {
+        _Jrt_object_monitorenter(contender->ref);
+        bench_sink += 1;
+        _Jrt_object_monitorexit(contender->ref);
+    }
+    return NULL;
+}
+
+static void bench_monitor_contended(void) {
+    const uint64_t iterations = 1000 * 1000;
+    struct contender contender = {.ref = bench_object_ref()};
+    atomic_init(&contender.stop, 0);
+    pthread_t thread;
+    ensure(pthread_create(&thread, NULL, contender_main, &contender));
+
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        _Jrt_object_monitorenter(contender.ref);
+        bench_sink += 1;
+        _Jrt_object_monitorexit(contender.ref);
+    }
+    uint64_t elapsed = now_nsec() - start;
+
+    atomic_store_explicit(&contender.stop, 1, memory_order_relaxed);
+    ensure(pthread_join(thread, NULL));
+    report("monitorenter/exit (contended)", iterations, elapsed);
+}
+
+static void bench_throw(void) {
+    const uint64_t iterations = 100 * 1000;
+    ref_t throwable = bench_object_ref();
+    uint64_t start = now_nsec();
+    uint64_t i;
+    for (i = 0; i < iterations; i++) {
+        bench_sink += bench_throw_catch(throwable);
+    }
+    report("_Jrt_throw round trip", iterations, now_nsec() - start);
+}
+
+static void bench_arraycopy(void) {
+    static const uint32_t counts[] = {4, 64, 1024, 16384};
+    size_t c;
+    for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        uint32_t count = counts[c];
+        uint64_t iterations = (64 * 1000 * 1000) / count;
+        ref_t src = _Jrt_array_new_4(count);
+        ref_t dest = _Jrt_array_new_4(count);
+        uint64_t start = now_nsec();
+        uint64_t i;
+        for (i = 0; i < iterations; i++) {
+            _ZN4java4lang6System9arraycopyIu9Jb7e57d76EEvN4java4lang6ObjectEiN4java4lang6ObjectEii(
+                src, 0, dest, 0, (int32_t)count);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "arraycopy (int[%u])", count);
+        report(name, iterations, now_nsec() - start);
+    }
+}
+
+int main(int argc, char **argv) {
+    (void)argv;
+    alloc_init();
+    gc_init(&argc);
+
+    bench_object_new();
+    bench_array_new();
+    bench_vtable_lookup();
+    bench_itable_lookup();
+    bench_monitor_uncontended();
+    bench_monitor_contended();
+    bench_throw();
+    bench_arraycopy();
+
+    return 0;
+}
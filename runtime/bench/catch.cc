@@ -0,0 +1,24 @@
+// The throw benchmark needs a landing pad, which plain C can't
+// express; this helper catches the runtime's foreign exception via
+// catch(...), so bench.c measures a full raise/unwind/catch round
+// trip. catch-and-return makes the unwinder call the exception's
+// cleanup hook, returning it to the per-thread pool.
+
+extern "C" {
+
+typedef struct {
+    void *object;
+    void *vtable;
+} ref_t;
+
+void _Jrt_throw(ref_t throwable);
+
+int bench_throw_catch(ref_t throwable) {
+    try {
+        _Jrt_throw(throwable);
+    } catch (...) {
+        return 1;
+    }
+    return 0;
+}
+}
@@ -0,0 +1,99 @@
+#ifndef ALLOC_H_
+#define ALLOC_H_
+
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+
+// Objects are carved out of large mmap'd chunks via a per-thread
+// bump pointer (TLAB). Allocations that don't fit the fast path go
+// through alloc_slow, which refills the TLAB from a fresh chunk or
+// falls back to malloc for oversized requests.
+//
+// Every allocation is preceded by an alloc_block header so that the
+// collector (lib/gc.h) can walk chunks, attribute interior pointers
+// to blocks, and reclaim dead ones.
+
+#define ALLOC_CHUNK_SIZE (1024 * 1024)
+#define ALLOC_LARGE_THRESHOLD (ALLOC_CHUNK_SIZE / 4)
+#define ALLOC_ALIGNMENT 8
+
+struct alloc_block {
+    uint32_t size; // block size in bytes, including this header
+    uint32_t flags;
+};
+
+#define ALLOC_BLOCK_FREE 0x1
+#define ALLOC_BLOCK_MARK 0x2
+
+#define ALLOC_BLOCK_PAYLOAD(block) ((uint8_t *)&(block)[1])
+
+struct alloc_chunk {
+    struct alloc_chunk *next;
+    uint8_t *limit;    // end of the initialized block sequence
+    uint64_t recycled; // handed out before; memory is no longer zeroed
+};
+
+#define ALLOC_CHUNK_BLOCKS(chunk) ((uint8_t *)&(chunk)[1])
+#define ALLOC_CHUNK_END(chunk) ((uint8_t *)(chunk) + ALLOC_CHUNK_SIZE)
+
+struct alloc_large {
+    struct alloc_large *next;
+    struct alloc_block block;
+};
+
+struct alloc_tlab {
+    uint8_t *top;
+    uint8_t *end;
+    struct alloc_chunk *chunk;
+    int zeroed; // chunk memory is kernel-zeroed and was never reused
+};
+
+extern _Thread_local struct alloc_tlab alloc_tlab;
+
+// all chunks and large allocations, for the collector to walk;
+// guarded by alloc_lock/alloc_unlock
+extern struct alloc_chunk *alloc_chunks;
+extern struct alloc_large *alloc_larges;
+
+void alloc_lock(void);
+void alloc_unlock(void);
+
+// reserves the heap up front (size taken from the JRT_HEAP_SIZE
+// environment variable, e.g. "256m" or "4g") and asks the kernel to
+// back it with transparent huge pages; chunks are then carved from
+// the reservation instead of paying one mmap each
+void alloc_init(void);
+
+void *alloc_slow(size_t size);
+
+// records the bump watermark in the active chunk and detaches the
+// TLAB; the next allocation refills from a fresh chunk
+void alloc_tlab_retire(void);
+
+// hands a fully-empty chunk back to the allocator for reuse
+// (caller must hold the allocation lock)
+void alloc_chunk_release(struct alloc_chunk *chunk);
+
+// returns zero-initialized memory, as required for object fields and
+// array elements; fresh mmap'd chunks are already zeroed by the
+// kernel, only recycled chunks pay for a memset
+static inline void *alloc(size_t size) {
+    size = (size + sizeof(struct alloc_block) + (ALLOC_ALIGNMENT - 1)) &
+           ~(size_t)(ALLOC_ALIGNMENT - 1);
+    uint8_t *top = alloc_tlab.top;
+    if ((size_t)(alloc_tlab.end - top) < size) {
+        return alloc_slow(size);
+    }
+    alloc_tlab.top = top + size;
+    if (!alloc_tlab.zeroed) {
+        memset(top, 0, size);
+    }
+    struct alloc_block *block = (struct alloc_block *)top;
+    block->size = (uint32_t)size;
+    block->flags = 0;
+    return ALLOC_BLOCK_PAYLOAD(block);
+}
+
+#endif // ALLOC_H_
@@ -15,14 +15,14 @@
 
 struct array_base {
     uint32_t length;
-    uint64_t width;
+    uint32_t width;
 };
 
 static inline ref_t array_new(uint32_t length, uint64_t width) {
     size_t data_size = sizeof(struct array_base) + length * width;
     ref_t ref = object_new(data_size, EXTERN_VTABLE_JAVA_LANG_OBJECT);
     ARRAY_BASE_PTR(ref)->length = length;
-    ARRAY_BASE_PTR(ref)->width = width;
+    ARRAY_BASE_PTR(ref)->width = (uint32_t)width;
     return ref;
 }
 
@@ -0,0 +1,58 @@
+#ifndef CLASS_H_
+#define CLASS_H_
+
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "ref.h"
+#include "extern.h"
+#include "object.h"
+
+// java.lang.Class instances are ordinary heap objects wrapping the
+// compiler-emitted metadata record; one instance per class, created
+// lazily and cached in the record's writable class_object slot.
+
+#define CLASS_BASE_PTR(ref) (OBJECT_DATA_PTR(ref, struct class_base))
+
+struct class_base {
+    struct ref_class_metadata *metadata;
+};
+
+static inline ref_t class_ref(void *object) {
+#ifdef JRT_COMPRESSED_REFS
+    ref_t ref = {
+        .object = object,
+    };
+#else
+    // TODO: use the real java.lang.Class vtable once its layout is
+    // emitted, analogous to the string placeholder in lib/string.h
+    ref_t ref = {
+        .object = object,
+        .vtable = EXTERN_VTABLE_JAVA_LANG_OBJECT,
+    };
+#endif
+    return ref;
+}
+
+static inline ref_t class_for_metadata(struct ref_class_metadata *metadata) {
+    void *cached = atomic_load_explicit(&metadata->class_object, memory_order_acquire);
+    if (cached == NULL) {
+        ref_t class_obj =
+            object_new(sizeof(struct class_base), EXTERN_VTABLE_JAVA_LANG_OBJECT);
+        CLASS_BASE_PTR(class_obj)->metadata = metadata;
+        void *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(
+                &metadata->class_object, &expected, class_obj.object,
+                memory_order_acq_rel, memory_order_acquire)) {
+            cached = class_obj.object;
+        } else {
+            // another thread published first; theirs is canonical
+            cached = expected;
+        }
+    }
+    return class_ref(cached);
+}
+
+#endif // CLASS_H_
@@ -0,0 +1,30 @@
+#ifndef GC_H_
+#define GC_H_
+
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+
+// Conservative non-moving mark-sweep collector over the chunked heap
+// from lib/alloc.h (see api/gc.c for the details).
+
+// records the base of the main thread's stack; no collection happens
+// before this is called
+void gc_init(void *stack_base);
+
+void gc_collect(void);
+
+// accounts `pending_bytes` of fresh allocation and collects once
+// enough has accumulated since the last cycle
+void gc_maybe_collect(size_t pending_bytes);
+
+// mutator thread bookkeeping: collection only runs while a single
+// mutator exists, until safepoints allow stopping the others
+void gc_mutator_attach(void);
+void gc_mutator_detach(void);
+
+// current number of attached mutators (including the caller); the
+// safepoint coordinator waits for all of the others
+uint32_t gc_mutator_count(void);
+
+#endif // GC_H_
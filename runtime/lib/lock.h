@@ -0,0 +1,75 @@
+#ifndef LOCK_H_
+#define LOCK_H_
+
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "thread.h"
+#include "monitor.h"
+
+// Thin object locks: uncontended monitorenter/monitorexit are a single
+// CAS on a header word, inflating to a heap-allocated monitor_t only on
+// contention or the first wait/notify.
+//
+// Lock word states:
+//   0                            unlocked
+//   (tid << 9) | (count << 1)    thin, held `count` times by thread `tid`
+//   (monitor_t *) | 1            inflated
+
+typedef _Atomic uintptr_t lockword_t;
+
+#define LOCK_INFLATED ((uintptr_t)1)
+#define LOCK_COUNT_SHIFT 1
+#define LOCK_COUNT_MAX 255
+#define LOCK_TID_SHIFT 9
+
+#define LOCK_MONITOR(word) ((monitor_t *)((word) & ~LOCK_INFLATED))
+#define LOCK_COUNT(word) (((word) >> LOCK_COUNT_SHIFT) & LOCK_COUNT_MAX)
+#define LOCK_TID(word) ((uint32_t)((word) >> LOCK_TID_SHIFT))
+#define LOCK_THIN(tid, count) \
+    (((uintptr_t)(tid) << LOCK_TID_SHIFT) | ((uintptr_t)(count) << LOCK_COUNT_SHIFT))
+
+void lock_enter_slow(lockword_t *word);
+monitor_t *lock_inflate(lockword_t *word);
+
+static inline void lock_init(lockword_t *word) {
+    atomic_init(word, 0);
+}
+
+static inline void lock_enter(lockword_t *word) {
+    uintptr_t expected = 0;
+    if (atomic_compare_exchange_strong_explicit(
+            word, &expected, LOCK_THIN(thread_id_self(), 1),
+            memory_order_acquire, memory_order_relaxed)) {
+        return;
+    }
+    lock_enter_slow(word);
+}
+
+static inline void lock_exit(lockword_t *word) {
+    uintptr_t current = atomic_load_explicit(word, memory_order_relaxed);
+    if (current & LOCK_INFLATED) {
+        monitor_exit(LOCK_MONITOR(current));
+        return;
+    }
+    // TODO: ensure calling thread owns the lock
+    if (LOCK_COUNT(current) > 1) {
+        atomic_store_explicit(word, current - ((uintptr_t)1 << LOCK_COUNT_SHIFT),
+                              memory_order_relaxed);
+    } else {
+        atomic_store_explicit(word, 0, memory_order_release);
+    }
+}
+
+// returns the inflated monitor, or NULL if the lock was never inflated
+// (in which case no thread can be waiting on it)
+static inline monitor_t *lock_monitor_peek(lockword_t *word) {
+    uintptr_t current = atomic_load_explicit(word, memory_order_acquire);
+    if (current & LOCK_INFLATED) {
+        return LOCK_MONITOR(current);
+    }
+    return NULL;
+}
+
+#endif // LOCK_H_
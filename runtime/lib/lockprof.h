@@ -0,0 +1,45 @@
+#ifndef LOCKPROF_H_
+#define LOCKPROF_H_
+
+#define _GNU_SOURCE 1
+#include <stdint.h>
+
+// Optional monitor contention instrumentation, enabled by building
+// with -DJRT_MONITOR_PROFILE. The default build compiles out to
+// nothing. When enabled, every contended monitor entry bumps
+// per-monitor counters (see lib/monitor.h), every Nth event lands in
+// a global ring buffer, and SIGUSR1 dumps the ring to stderr.
+
+#ifdef JRT_MONITOR_PROFILE
+
+struct lockprof_event {
+    void *monitor;
+    uint32_t thread_id;
+    // how long this entry blocked, and the monitor's cumulative
+    // counters at sample time (so the dump never dereferences a
+    // possibly-reclaimed monitor)
+    uint64_t blocked_nsec;
+    uint64_t total_entries;
+    uint64_t total_blocked_nsec;
+};
+
+#define LOCKPROF_RING_SIZE 256
+#define LOCKPROF_SAMPLE_INTERVAL 16
+
+// installs the SIGUSR1 dump handler
+void lockprof_init(void);
+
+// coarse monotonic timestamp; resolution is a few milliseconds but
+// reading it stays off the slow path's critical cost
+uint64_t lockprof_now_nsec(void);
+
+void lockprof_sample(void *monitor, uint64_t blocked_nsec, uint64_t total_entries,
+                     uint64_t total_blocked_nsec);
+
+#else
+
+#define lockprof_init()
+
+#endif
+
+#endif // LOCKPROF_H_
@@ -0,0 +1,23 @@
+#ifndef METADATA_H_
+#define METADATA_H_
+
+#define _GNU_SOURCE 1
+
+// Shared metadata image support. The compiler places read-only class
+// metadata — vtable constants and string constant bytes — into a
+// dedicated "jrt_metadata" section. When JRT_METADATA_IMAGE names an
+// image file (ideally on /dev/shm), the first process dumps the
+// relocated section there and every later process of the same build
+// maps the file read-only and shared over its private copy, so the
+// fleet shares one set of physical metadata pages instead of
+// faulting in and relocating a private set each.
+//
+// A checksum over the live section guards the mapping: a different
+// build, or a different ASLR base shifting the embedded pointers,
+// fails the match and the process silently keeps its private pages.
+
+// maps or publishes the image; called once from _Jrt_start, and a
+// no-op unless JRT_METADATA_IMAGE is set
+void metadata_init(void);
+
+#endif // METADATA_H_
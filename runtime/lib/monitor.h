@@ -7,23 +7,60 @@
 #include <errno.h>
 
 #include "utils.h"
+#include "lockprof.h"
 
 typedef struct {
     pthread_mutex_t mutex;
     pthread_cond_t condvar;
+#ifdef JRT_MONITOR_PROFILE
+    // updated under the mutex, read from sampled dump events
+    uint64_t contended_entries;
+    uint64_t blocked_nsec;
+#endif
 } monitor_t;
 
 static inline void monitor_init(monitor_t *monitor) {
 #ifdef __GLIBC__
     monitor->mutex = (pthread_mutex_t)PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+    // timed waits measure against the monotonic clock, so NTP steps
+    // on the wall clock don't distort them
+    {
+        pthread_condattr_t attr;
+        ensure(pthread_condattr_init(&attr));
+        ensure(pthread_condattr_setclock(&attr, CLOCK_MONOTONIC));
+        ensure(pthread_cond_init(&monitor->condvar, &attr));
+        ensure(pthread_condattr_destroy(&attr));
+    }
 #elif __APPLE__
     monitor->mutex = (pthread_mutex_t)PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
-#endif
     monitor->condvar = (pthread_cond_t)PTHREAD_COND_INITIALIZER;
+#endif
+#ifdef JRT_MONITOR_PROFILE
+    monitor->contended_entries = 0;
+    monitor->blocked_nsec = 0;
+#endif
+}
+
+static inline void monitor_destroy(monitor_t *monitor) {
+    ensure(pthread_mutex_destroy(&monitor->mutex));
+    ensure(pthread_cond_destroy(&monitor->condvar));
 }
 
 static inline void monitor_enter(monitor_t *monitor) {
+#ifdef JRT_MONITOR_PROFILE
+    if (pthread_mutex_trylock(&monitor->mutex) == 0) {
+        return;
+    }
+    uint64_t start = lockprof_now_nsec();
+    ensure(pthread_mutex_lock(&monitor->mutex));
+    uint64_t blocked = lockprof_now_nsec() - start;
+    monitor->contended_entries += 1;
+    monitor->blocked_nsec += blocked;
+    lockprof_sample(monitor, blocked, monitor->contended_entries,
+                    monitor->blocked_nsec);
+#else
     ensure(pthread_mutex_lock(&monitor->mutex));
+#endif
 }
 
 static inline void monitor_exit(monitor_t *monitor) {
@@ -35,7 +72,11 @@ static inline void monitor_wait(monitor_t *monitor, uint64_t timeout) {
 
     if (timeout > 0) {
         struct timespec abstime;
+#ifdef __GLIBC__
+        timespec_now_monotonic(&abstime);
+#else
         timespec_now(&abstime);
+#endif
         timespec_add_msec(&abstime, timeout);
 
         err = pthread_cond_timedwait(&monitor->condvar, &monitor->mutex, &abstime);
@@ -5,24 +5,58 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 
 #include "ref.h"
-#include "monitor.h"
+#include "alloc.h"
+#include "lock.h"
 
 #define OBJECT_BASE_PTR(ref) ((struct object_base *)ref.object)
 #define OBJECT_DATA_PTR(ref, typ) ((typ *)&OBJECT_BASE_PTR(ref)[1])
 
 struct object_base {
-    monitor_t monitor;
+#ifdef JRT_COMPRESSED_REFS
+    // must stay the first word: REF_VTABLE_PTR reads it through
+    // struct ref_header in lib/ref.h
+    void *vtable;
+#endif
+    lockword_t lock;
+    // identity hash, lazily computed on first use; 0 means "not yet"
+    _Atomic uint32_t hash;
 };
 
+// Mixes the object's address through a multiply-xorshift step and
+// stores the result in the header, so the hash spreads well across
+// map buckets and stays stable even if the object ever moves. Racing
+// initializers compute the same value, so relaxed ordering suffices.
+static inline uint32_t object_identity_hash(struct object_base *base) {
+    uint32_t hash = atomic_load_explicit(&base->hash, memory_order_relaxed);
+    if (hash == 0) {
+        uint64_t mix = (uintptr_t)base * 0x9e3779b97f4a7c15ull;
+        mix ^= mix >> 32;
+        hash = (uint32_t)mix;
+        if (hash == 0) {
+            hash = 1;
+        }
+        atomic_store_explicit(&base->hash, hash, memory_order_relaxed);
+    }
+    return hash;
+}
+
 static inline ref_t object_new(uint32_t data_size, void *vtable) {
     size_t size = sizeof(struct object_base) + data_size;
+#ifdef JRT_COMPRESSED_REFS
+    ref_t ref = {
+        .object = alloc(size),
+    };
+    OBJECT_BASE_PTR(ref)->vtable = vtable;
+#else
     ref_t ref = {
-        .object = malloc(size),
+        .object = alloc(size),
         .vtable = vtable,
     };
-    monitor_init(&OBJECT_BASE_PTR(ref)->monitor);
+#endif
+    lock_init(&OBJECT_BASE_PTR(ref)->lock);
     return ref;
 }
 
@@ -0,0 +1,34 @@
+#ifndef PARK_H_
+#define PARK_H_
+
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Lightweight park/unpark primitive: a single futex word with an
+// adaptive spin phase before sleeping in the kernel. Deadlines are
+// measured against CLOCK_MONOTONIC, so NTP steps don't distort timed
+// waits. Usable for Thread.sleep, LockSupport-style parking and the
+// inflated-monitor slow path.
+
+typedef struct {
+    // 0 = no permit, 1 = permit available
+    _Atomic uint32_t state;
+} park_t;
+
+#define PARK_INITIALIZER {0}
+
+static inline void park_init(park_t *park) {
+    atomic_init(&park->state, 0);
+}
+
+// blocks until a permit is available (consuming it) or, if
+// timeout_msec > 0, until the timeout elapses
+void park_wait(park_t *park, uint64_t timeout_msec);
+
+// makes a permit available, waking a parked thread if there is one
+void park_wake(park_t *park);
+
+void _Jrt_thread_sleep(uint64_t msec);
+
+#endif // PARK_H_
@@ -0,0 +1,55 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#define _GNU_SOURCE 1
+#include <stdint.h>
+#include <stddef.h>
+
+// Optional entry-point and allocation profiling, enabled by building
+// with -DJRT_PROFILE (the `make prof` archive). Call sites use the
+// PROFILE_* macros, which compile out entirely in the default build.
+// Counters are kept per thread and flushed into global totals when a
+// thread exits; the process-exit hook prints totals, per-entry size
+// histograms, and sampled allocation backtraces to stderr.
+
+enum profile_entry_point {
+    PROFILE_OBJECT_NEW,
+    PROFILE_ARRAY_NEW,
+    PROFILE_LDSTR,
+    PROFILE_THROW,
+    PROFILE_VTABLE_LOOKUP,
+    PROFILE_ITABLE_LOOKUP,
+    PROFILE_ENTRY_POINTS
+};
+
+#ifdef JRT_PROFILE
+
+// log2-bucketed allocation size histogram per entry point
+#define PROFILE_SIZE_BUCKETS 16
+
+// one allocation backtrace is recorded every this many bytes
+#define PROFILE_SAMPLE_BYTES (1024 * 1024)
+
+// installs the process-exit dump hook
+void profile_init(void);
+
+void profile_count(enum profile_entry_point entry_point);
+void profile_alloc(enum profile_entry_point entry_point, size_t bytes);
+
+// merges this thread's counters into the global totals
+void profile_flush(void);
+
+#define PROFILE_COUNT(entry_point) profile_count(entry_point)
+#define PROFILE_ALLOC(entry_point, bytes) profile_alloc(entry_point, bytes)
+
+#else
+
+#define profile_init()
+#define profile_flush()
+
+#define PROFILE_COUNT(entry_point)
+#define PROFILE_ALLOC(entry_point, bytes)
+
+#endif
+
+#endif // PROFILE_H_
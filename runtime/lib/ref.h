@@ -1,13 +1,56 @@
 #ifndef REF_H_
 #define REF_H_
 
+// References are fat two-word values by default: the vtable travels
+// next to the object pointer, so virtual dispatch never touches the
+// object header. Building with -DJRT_COMPRESSED_REFS shrinks ref_t to
+// a single word and moves the vtable into the object header (see
+// lib/object.h), halving the footprint of reference fields, reference
+// arrays and argument registers at the cost of one header load per
+// dispatch. The compiler backend still emits the fat two-word ABI, so
+// compressed mode is opt-in until codegen grows a matching mode.
+
+#ifdef JRT_COMPRESSED_REFS
+
+typedef struct {
+    void *object;
+} ref_t;
+
+// in compressed mode the vtable is the first word of every object
+// header; lib/object.h lays out struct object_base to match
+struct ref_header {
+    void *vtable;
+};
+
+#define REF_NULL ((ref_t) { .object = NULL })
+#define REF_VTABLE_PTR(ref) ((struct ref_vtable_base *)((struct ref_header *)ref.object)->vtable)
+
+#else
+
 typedef struct {
     void *object;
     void *vtable;
 } ref_t;
 
+#define REF_NULL ((ref_t) { .object = NULL, .vtable = NULL })
+#define REF_VTABLE_PTR(ref) ((struct ref_vtable_base *)ref.vtable)
+
+#endif
+
+// Per-class metadata record, emitted by the compiler next to the
+// vtable (_ZTI alongside _ZTV) and reachable from it in one
+// constant-offset load. `class_object` is a writable slot where the
+// runtime caches the lazily created java.lang.Class instance (see
+// lib/class.h).
+struct ref_class_metadata {
+    const char *name;
+    void *super_vtable;
+    void *_Atomic class_object;
+};
+
 struct ref_vtable_base {
     uint32_t length;
+    struct ref_class_metadata *metadata;
     void *methods[];
 };
 
@@ -21,10 +64,6 @@ struct ref_itable_base {
     struct ref_itable_entry entries[];
 };
 
-#define REF_NULL ((ref_t) { .object = NULL, .vtable = NULL })
-#define REF_HASH(ref) ((uint32_t)(intptr_t)ref.object)
-
-#define REF_VTABLE_PTR(ref) ((struct ref_vtable_base *)ref.vtable)
 #define REF_ITABLE_PTR(ref) ((struct ref_itable_base *)&REF_VTABLE_PTR(ref)->methods[REF_VTABLE_PTR(ref)->length])
 
 #endif // REF_H_
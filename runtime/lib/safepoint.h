@@ -0,0 +1,37 @@
+#ifndef SAFEPOINT_H_
+#define SAFEPOINT_H_
+
+#define _GNU_SOURCE 1
+#include <stdint.h>
+
+// Cooperative stop-the-world support. Compiled code polls with a
+// plain load from the safepoint page at method entries and loop
+// back-edges; while the page is readable that poll is an L1 hit. To
+// stop the world a coordinating thread arms the page by mprotecting
+// it to PROT_NONE, turning every poll into a fault that the signal
+// handler routes to _Jrt_safepoint_slow, where the polling thread
+// parks until the page is disarmed.
+
+// the page compiled code polls; page-aligned so the mprotect can't
+// take neighboring data with it
+extern char _Jrt_safepoint_page[4096];
+
+// installs the fault handler; called once from _Jrt_start
+void safepoint_init(void);
+
+// arms the poll page and blocks until every other mutator has parked
+// in _Jrt_safepoint_slow; pairs with safepoint_end. The caller must
+// not touch the page while it holds the safepoint (its own poll would
+// park it against itself). Threads blocked in native code don't poll;
+// handing those off as already-safe is left for when the collector
+// starts stopping threads.
+void safepoint_begin(void);
+
+// disarms the poll page and releases the parked mutators
+void safepoint_end(void);
+
+// park point for a thread whose poll faulted; also callable directly
+// from runtime code that wants to honor a pending safepoint
+void _Jrt_safepoint_slow(void);
+
+#endif // SAFEPOINT_H_
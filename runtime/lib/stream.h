@@ -0,0 +1,25 @@
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffered output stream flushed with vectored writes: small prints
+// accumulate in the buffer, large payloads are written out together
+// with the buffered bytes in a single writev without being copied.
+
+#define STREAM_BUFFER_SIZE (64 * 1024)
+
+typedef struct {
+    int fd;
+    size_t len;
+    uint8_t buffer[STREAM_BUFFER_SIZE];
+} stream_t;
+
+extern stream_t stream_stdout;
+
+void stream_write(stream_t *stream, const void *bytes, size_t len);
+void stream_flush(stream_t *stream);
+
+#endif // STREAM_H_
@@ -1,16 +1,79 @@
 #ifndef STRING_H_
 #define STRING_H_
 
-#include "stddef.h"
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "ref.h"
+#include "extern.h"
+#include "object.h"
 
-static inline ref_t string_new(void *bytes) {
-    // horrible hack! :(
-    return (ref_t) {
-        .object = bytes,
-        .vtable = NULL
+// Strings are real heap objects: a header with cached byte length and
+// hash, followed by the bytes inline (NUL-terminated, so the data can
+// still be handed to C APIs).
+
+#define STRING_BASE_PTR(ref) (OBJECT_DATA_PTR(ref, struct string_base))
+#define STRING_DATA_PTR(ref) ((char *)&STRING_BASE_PTR(ref)[1])
+
+struct string_base {
+    uint32_t length; // in bytes, excluding the terminating NUL
+    uint32_t hash;   // cached hashCode; 0 means not yet computed
+};
+
+// reconstructs a ref from a bare object pointer (intern table slots
+// and ldc-site caches store a single word, not a fat ref)
+static inline ref_t string_ref(void *object) {
+#ifdef JRT_COMPRESSED_REFS
+    ref_t ref = {
+        .object = object,
     };
+#else
+    // TODO: use a proper java.lang.String vtable once one is emitted
+    ref_t ref = {
+        .object = object,
+        .vtable = EXTERN_VTABLE_JAVA_LANG_OBJECT,
+    };
+#endif
+    return ref;
+}
+
+static inline ref_t string_new_with_length(const char *bytes, uint32_t length) {
+    // TODO: use a proper java.lang.String vtable once one is emitted
+    ref_t ref = object_new(sizeof(struct string_base) + length + 1,
+                           EXTERN_VTABLE_JAVA_LANG_OBJECT);
+    struct string_base *base = STRING_BASE_PTR(ref);
+    base->length = length;
+    base->hash = 0;
+    char *data = STRING_DATA_PTR(ref);
+    memcpy(data, bytes, length);
+    data[length] = '\0';
+    return ref;
+}
+
+static inline ref_t string_new(const char *bytes) {
+    return string_new_with_length(bytes, (uint32_t)strlen(bytes));
+}
+
+static inline uint32_t string_length(ref_t ref) {
+    return STRING_BASE_PTR(ref)->length;
+}
+
+// computed over the utf-8 bytes rather than UTF-16 code units, which
+// agrees with java.lang.String for ASCII content
+static inline uint32_t string_hash(ref_t ref) {
+    struct string_base *base = STRING_BASE_PTR(ref);
+    uint32_t hash = base->hash;
+    if (hash == 0) {
+        const char *data = STRING_DATA_PTR(ref);
+        uint32_t i;
+        for (i = 0; i < base->length; i++) {
+            hash = 31 * hash + (uint8_t)data[i];
+        }
+        base->hash = hash;
+    }
+    return hash;
 }
 
 #endif // STRING_H_
@@ -0,0 +1,66 @@
+#ifndef STRINGBUILDER_H_
+#define STRINGBUILDER_H_
+
+#define _GNU_SOURCE 1
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+
+#include "ref.h"
+#include "object.h"
+#include "array.h"
+#include "string.h"
+
+// Native java.lang.StringBuilder: a geometrically-growing byte buffer
+// (a width-1 array, so the collector sees it through the builder's
+// fields) plus the used length. The layout mirrors the JDK's
+// value/count fields and fits in the instance size the compiler
+// computes for StringBuilder.
+
+#define STRINGBUILDER_BASE_PTR(ref) (OBJECT_DATA_PTR(ref, struct stringbuilder_base))
+
+#define STRINGBUILDER_INITIAL_CAPACITY 16
+
+struct stringbuilder_base {
+    ref_t buffer;    // byte array holding the contents
+    uint32_t length; // bytes used
+};
+
+static inline void stringbuilder_init(ref_t ref) {
+    struct stringbuilder_base *base = STRINGBUILDER_BASE_PTR(ref);
+    base->buffer = array_new(STRINGBUILDER_INITIAL_CAPACITY, 1);
+    base->length = 0;
+}
+
+static inline void stringbuilder_reserve(ref_t ref, uint32_t extra) {
+    struct stringbuilder_base *base = STRINGBUILDER_BASE_PTR(ref);
+    uint32_t capacity = ARRAY_BASE_PTR(base->buffer)->length;
+    if (capacity - base->length >= extra) {
+        return;
+    }
+    uint32_t grown_capacity = capacity * 2;
+    while (grown_capacity - base->length < extra) {
+        grown_capacity *= 2;
+    }
+    ref_t grown = array_new(grown_capacity, 1);
+    memcpy(ARRAY_DATA_PTR(grown, char), ARRAY_DATA_PTR(base->buffer, char),
+           base->length);
+    base->buffer = grown;
+}
+
+static inline void stringbuilder_append_bytes(ref_t ref, const char *bytes,
+                                              uint32_t len) {
+    stringbuilder_reserve(ref, len);
+    struct stringbuilder_base *base = STRINGBUILDER_BASE_PTR(ref);
+    memcpy(&ARRAY_DATA_PTR(base->buffer, char)[base->length], bytes, len);
+    base->length += len;
+}
+
+// the string header keeps its bytes inline, so handing the buffer off
+// without a copy is not possible with the current string layout
+static inline ref_t stringbuilder_to_string(ref_t ref) {
+    struct stringbuilder_base *base = STRINGBUILDER_BASE_PTR(ref);
+    return string_new_with_length(ARRAY_DATA_PTR(base->buffer, char), base->length);
+}
+
+#endif // STRINGBUILDER_H_
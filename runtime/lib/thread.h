@@ -2,8 +2,11 @@
 #define THREAD_H_
 
 #define _GNU_SOURCE 1
+#include <stdint.h>
 #include <pthread.h>
 
+#include "ref.h"
+
 static inline void thread_name_set(const char *name) {
     #ifdef __GLIBC__
         pthread_t self = pthread_self();
@@ -18,4 +21,49 @@ static inline int thread_name_get(char *name, size_t len) {
     return pthread_getname_np(self, name, len);
 }
 
+// observable execution state, published with release stores at the
+// transitions so the safepoint coordinator (and eventually a sampling
+// profiler) reads a settled value
+enum thread_state {
+    THREAD_STATE_RUNNING = 0,
+    THREAD_STATE_SAFEPOINT = 1,
+};
+
+extern _Thread_local _Atomic uint32_t thread_state_tls;
+
+// small nonzero per-thread id, assigned lazily on first use
+extern _Thread_local uint32_t thread_id_tls;
+
+uint32_t thread_id_assign(void);
+
+static inline uint32_t thread_id_self(void) {
+    uint32_t id = thread_id_tls;
+    if (id == 0) {
+        id = thread_id_assign();
+        thread_id_tls = id;
+    }
+    return id;
+}
+
+// runtime record for a started Thread object; registry nodes stay
+// alive until the thread is joined
+struct thread {
+    struct thread *next;
+    pthread_t pthread;
+    void *stack;
+    void (*entry)(ref_t);
+    ref_t object;
+    char name[16];
+};
+
+// all running (not yet joined) threads, for the collector to treat
+// their Thread objects as roots; guarded by thread_registry_lock
+extern struct thread *thread_registry;
+
+void thread_registry_lock(void);
+void thread_registry_unlock(void);
+
+void _Jrt_thread_start(ref_t thread, void (*entry)(ref_t));
+void _Jrt_thread_join(ref_t thread);
+
 #endif // THREAD_H_
@@ -12,6 +12,15 @@
     abort();\
 }
 
+// marks hot loops the compiler should vectorize; on x86-64/glibc,
+// target_clones adds an AVX2 version next to the SSE2 baseline,
+// selected once at load time through an ifunc
+#if defined(__x86_64__) && defined(__GLIBC__)
+#define JRT_BULKOP __attribute__((target_clones("avx2", "default")))
+#else
+#define JRT_BULKOP
+#endif
+
 static inline void ensure(int errcode) {
     if (errcode != 0) {\
         PANIC("Internal operation failed. Aborting.");\
@@ -33,6 +42,16 @@ static inline void timespec_now(struct timespec *ts) {
 #endif
 }
 
+// monotonic clock for deadlines: immune to NTP steps, unlike
+// CLOCK_REALTIME above
+static inline void timespec_now_monotonic(struct timespec *ts) {
+#ifdef __MACH__
+    timespec_now(ts);
+#else
+    ensure(clock_gettime(CLOCK_MONOTONIC, ts));
+#endif
+}
+
 static inline void timespec_add_msec(struct timespec *ts, uint64_t msec) {
     int sec = msec / 1000;
     msec = msec - sec * 1000;